@@ -0,0 +1,138 @@
+#ifndef LIBBASE_CHARNAMEINDEX_HH
+#define LIBBASE_CHARNAMEINDEX_HH
+
+#include <base/Result.hh>
+#include <base/Text.hh>
+#include <base/Types.hh>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace base {
+namespace ser {
+template <typename T>
+struct Serialiser;
+}
+
+namespace text {
+class CharNameIndex;
+}
+}
+
+/// Index of the names of Unicode characters.
+///
+/// Finding characters by name using ICU means enumerating the names of
+/// all characters every time. The index instead stores all names in one
+/// string and records, for every trigram (sequence of three characters)
+/// that occurs in any name, which names contain it; a substring query
+/// then only has to look at the names that contain the rarest trigram
+/// of the query.
+///
+/// Building the index requires Unicode support, but the index can be
+/// serialised, and a serialised index can be loaded and queried without
+/// it, e.g.
+///
+/// \code
+///     auto bytes = ser::Serialise<std::endian::little>(CharNameIndex::Get());
+///     auto index = ser::Deserialise<CharNameIndex, std::endian::little>(bytes).value();
+///     auto hearts = index.find("heart");
+/// \endcode
+class base::text::CharNameIndex {
+    friend ser::Serialiser<CharNameIndex>;
+
+    /// The indexed characters, in ascending order.
+    std::vector<char32_t> chars;
+
+    /// Offset of the name of each character in 'names', followed by
+    /// the size of 'names'.
+    std::vector<u32> name_offsets{0};
+
+    /// The names of all characters, concatenated.
+    std::string names;
+
+    /// All trigrams that occur in any name, in ascending order.
+    std::vector<u32> trigrams;
+
+    /// Offset of the postings of each trigram in 'postings', followed
+    /// by the size of 'postings'.
+    std::vector<u32> posting_offsets{0};
+
+    /// For each trigram, the indices of the names that contain it, in
+    /// ascending order.
+    std::vector<u32> postings;
+
+public:
+    /// Create an empty index.
+    CharNameIndex() = default;
+
+#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
+    /// Build an index of the names of all characters in [from, to].
+    [[nodiscard]] static auto Build(c32 from = U'\0', c32 to = c32::max()) -> CharNameIndex;
+
+    /// Get an index of the names of all characters.
+    ///
+    /// The index is built the first time this is called.
+    [[nodiscard]] static auto Get() -> const CharNameIndex&;
+#endif
+
+    /// Find all characters whose name contains a string.
+    ///
+    /// The query is matched case-insensitively. Queries that are shorter
+    /// than three characters have to check every name.
+    [[nodiscard]] auto find(std::string_view query) const -> std::vector<c32>;
+
+    /// Find all characters in [from, to] whose name satisfies a predicate.
+    ///
+    /// \see FindCharsByName()
+    [[nodiscard]] auto find_if(
+        std::function<bool(c32, std::string_view)> filter,
+        c32 from = U'\0',
+        c32 to = c32::max()
+    ) const -> std::vector<c32>;
+
+    /// Get the name of a character.
+    ///
+    /// Returns std::nullopt if the character is not in the index.
+    [[nodiscard]] auto name(c32 c) const -> std::optional<std::string_view>;
+
+    /// Get the number of characters in the index.
+    [[nodiscard]] auto size() const -> usz { return chars.size(); }
+
+private:
+    /// Check that the tables are consistent with one another.
+    [[nodiscard]] auto check() const -> Result<>;
+
+    /// Get the name at an index.
+    [[nodiscard]] auto name_at(usz i) const -> std::string_view {
+        return std::string_view{names}.substr(name_offsets[i], name_offsets[i + 1] - name_offsets[i]);
+    }
+};
+
+/// Serialiser for character name indices.
+///
+/// This stores the tables as-is so loading an index doesn’t have to
+/// rebuild the trigram index.
+template <>
+struct base::ser::Serialiser<base::text::CharNameIndex> {
+    using Index = text::CharNameIndex;
+
+    static auto deserialise(auto& r) -> Result<Index> {
+        Index idx;
+        idx.chars = Try(r.template read<std::vector<char32_t>>());
+        idx.name_offsets = Try(r.template read<std::vector<u32>>());
+        idx.names = Try(r.template read<std::string>());
+        idx.trigrams = Try(r.template read<std::vector<u32>>());
+        idx.posting_offsets = Try(r.template read<std::vector<u32>>());
+        idx.postings = Try(r.template read<std::vector<u32>>());
+        Try(idx.check());
+        return idx;
+    }
+
+    static void serialise(auto& w, const Index& idx) {
+        w(idx.chars, idx.name_offsets, idx.names, idx.trigrams, idx.posting_offsets, idx.postings);
+    }
+};
+
+#endif // LIBBASE_CHARNAMEINDEX_HH
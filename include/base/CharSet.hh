@@ -0,0 +1,190 @@
+#ifndef LIBBASE_CHARSET_HH
+#define LIBBASE_CHARSET_HH
+
+#include <array>
+#include <base/Types.hh>
+#include <bit>
+#include <string_view>
+#include <type_traits>
+
+namespace base {
+class CharSet;
+
+namespace detail {
+/// Find the first byte that is (or isn’t, if 'negate' is set) in a set.
+///
+/// Returns 'size' if there is no such byte.
+auto FindFirstInSet(const CharSet& set, const char* data, usz size, bool negate) noexcept -> usz;
+
+/// Count the number of bytes that are in a set.
+auto CountInSet(const CharSet& set, const char* data, usz size) noexcept -> usz;
+}
+}
+
+/// Precomputed set of byte-sized characters.
+///
+/// This is a 256-bit bitmap that can be used with the '_any' family of
+/// str functions in place of a string of characters. Scanning text for
+/// the characters in a set is vectorised where possible, so prefer this
+/// over passing the same string of characters repeatedly on hot paths.
+///
+/// The set can only contain characters whose value is less than 256; when
+/// used with wider character types, any character outside that range is
+/// never part of the set.
+class base::CharSet {
+    friend auto detail::FindFirstInSet(const CharSet&, const char*, usz, bool) noexcept -> usz;
+    friend auto detail::CountInSet(const CharSet&, const char*, usz) noexcept -> usz;
+
+    /// The bitmap is laid out so it can be used as a pair of shuffle tables
+    /// indexed by the low nibble of a character: byte 'L' holds the bits for
+    /// the characters '0xHL' where 'H' < 8, and byte 'L + 16' those where 'H'
+    /// >= 8; bit 'H % 8' is set if the character is in the set.
+    std::array<u8, 32> bits{};
+
+    static constexpr auto Index(u32 v) -> usz { return usz(((v >> 7) << 4) | (v & 15)); }
+    static constexpr auto Bit(u32 v) -> u8 { return u8(1 << ((v >> 4) & 7)); }
+
+public:
+    /// Create an empty set.
+    constexpr CharSet() = default;
+
+    /// Create a set that contains the characters in a string.
+    constexpr explicit CharSet(std::string_view chars) {
+        for (auto c : chars) add(c);
+    }
+
+    /// Create a set that contains all characters that satisfy a predicate.
+    ///
+    /// This is evaluated at compile time, so it can be used to turn
+    /// predicates such as 'text::IsAlnum' into a lookup table, e.g.
+    ///
+    /// \code
+    ///     static constexpr auto Ident = CharSet::FromPredicate(text::IsAlnum) | CharSet{"_"};
+    /// \endcode
+    template <typename Predicate>
+    [[nodiscard]] static consteval auto FromPredicate(Predicate pred) -> CharSet {
+        CharSet s;
+        for (u32 c = 0; c < 256; c++)
+            if (pred(char(c)))
+                s.add(c);
+        return s;
+    }
+
+    /// Create a set that contains all characters in a range, inclusive.
+    [[nodiscard]] static consteval auto FromRange(char first, char last) -> CharSet {
+        CharSet s;
+        for (auto c = u32(u8(first)); c <= u32(u8(last)); c++) s.add(c);
+        return s;
+    }
+
+    /// Add a character to the set.
+    template <typename Char>
+    requires std::is_integral_v<Char>
+    constexpr void add(Char c) {
+        auto v = u32(std::make_unsigned_t<Char>(c));
+        if (v < 256) bits[Index(v)] |= Bit(v);
+    }
+
+    /// Check if the set contains a character.
+    template <typename Char>
+    requires std::is_integral_v<Char>
+    [[nodiscard]] constexpr bool contains(Char c) const {
+        auto v = u32(std::make_unsigned_t<Char>(c));
+        return v < 256 and (bits[Index(v)] & Bit(v));
+    }
+
+    /// Check if the set is empty.
+    [[nodiscard]] constexpr bool empty() const {
+        for (auto b : bits)
+            if (b) return false;
+        return true;
+    }
+
+    /// Get the number of characters in the set.
+    [[nodiscard]] constexpr auto size() const -> usz {
+        usz n = 0;
+        for (auto b : bits) n += usz(std::popcount(b));
+        return n;
+    }
+
+    /// Find the first character in a string that is in the set.
+    ///
+    /// \return The index of the character, or 'text.size()' if there is none.
+    template <typename Char>
+    [[nodiscard]] constexpr auto find_first(std::basic_string_view<Char> text) const -> usz {
+        return find_first_impl(text, false);
+    }
+
+    /// Find the first character in a string that is not in the set.
+    ///
+    /// \return The index of the character, or 'text.size()' if there is none.
+    template <typename Char>
+    [[nodiscard]] constexpr auto find_first_not(std::basic_string_view<Char> text) const -> usz {
+        return find_first_impl(text, true);
+    }
+
+    /// Find the last character in a string that is not in the set.
+    ///
+    /// \return The index of the character, or 'npos' if there is none.
+    template <typename Char>
+    [[nodiscard]] constexpr auto find_last_not(std::basic_string_view<Char> text) const -> usz {
+        for (usz i = text.size(); i > 0; i--)
+            if (not contains(text[i - 1]))
+                return i - 1;
+        return std::basic_string_view<Char>::npos;
+    }
+
+    /// Count how many characters in a string are in the set.
+    template <typename Char>
+    [[nodiscard]] constexpr auto count(std::basic_string_view<Char> text) const -> usz {
+        if !consteval {
+            if constexpr (sizeof(Char) == 1) {
+                return detail::CountInSet(*this, reinterpret_cast<const char*>(text.data()), text.size());
+            }
+        }
+
+        usz n = 0;
+        for (auto c : text) n += contains(c);
+        return n;
+    }
+
+    /// Get the union of two sets.
+    [[nodiscard]] constexpr auto operator|(const CharSet& other) const -> CharSet {
+        CharSet s;
+        for (usz i = 0; i < bits.size(); i++) s.bits[i] = u8(bits[i] | other.bits[i]);
+        return s;
+    }
+
+    /// Get the intersection of two sets.
+    [[nodiscard]] constexpr auto operator&(const CharSet& other) const -> CharSet {
+        CharSet s;
+        for (usz i = 0; i < bits.size(); i++) s.bits[i] = u8(bits[i] & other.bits[i]);
+        return s;
+    }
+
+    /// Get the complement of this set.
+    [[nodiscard]] constexpr auto operator~() const -> CharSet {
+        CharSet s;
+        for (usz i = 0; i < bits.size(); i++) s.bits[i] = u8(~bits[i]);
+        return s;
+    }
+
+    [[nodiscard]] constexpr bool operator==(const CharSet&) const = default;
+
+private:
+    template <typename Char>
+    constexpr auto find_first_impl(std::basic_string_view<Char> text, bool negate) const -> usz {
+        if !consteval {
+            if constexpr (sizeof(Char) == 1) {
+                return detail::FindFirstInSet(*this, reinterpret_cast<const char*>(text.data()), text.size(), negate);
+            }
+        }
+
+        for (usz i = 0; i < text.size(); i++)
+            if (contains(text[i]) != negate)
+                return i;
+        return text.size();
+    }
+};
+
+#endif // LIBBASE_CHARSET_HH
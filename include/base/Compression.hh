@@ -3,17 +3,27 @@
 
 #ifdef LIBBASE_ENABLE_ZSTD
 
+#include <base/Macros.hh>
 #include <base/Serialisation.hh>
 #include <base/Size.hh>
+#include <functional>
+#include <memory>
+#include <optional>
 
 namespace base {
 constexpr int MaxCompressionLevel = std::numeric_limits<int>::max();
 
+/// Default amount of data that a CompressingSink compresses at once.
+constexpr usz DefaultCompressionBlockSize = 1024 * 1024;
+
+class CompressingSink;
+class DecompressingSource;
+
 namespace detail {
 [[nodiscard]] auto CompressImpl(MutableByteSpan output, ByteSpan input, std::optional<int> compression_level) -> usz;
-[[nodiscard]] auto DecompressImpl(MutableByteSpan output, ByteSpan input) -> Result<usz>;
+[[nodiscard]] auto DecompressImpl(MutableByteSpan output, ByteSpan input) -> Result<usz, CompactError>;
 [[nodiscard]] auto GetCompressedSize(ByteSpan input) -> usz;
-[[nodiscard]] auto GetDecompressedSize(ByteSpan input) -> Result<usz>;
+[[nodiscard]] auto GetDecompressedSize(ByteSpan input) -> Result<usz, CompactError>;
 }
 
 /// Compresses a sequence of bytes into a container.
@@ -67,7 +77,7 @@ template <typename Buffer>
 auto DecompressInto(
     Buffer& into,
     ByteSpan input
-) -> Result<> {
+) -> Result<void, CompactError> {
     static_assert(BytePointer<decltype(into.data())>);
 
     // Take care not to overwrite data that is already in the buffer.
@@ -90,13 +100,95 @@ auto DecompressInto(
 ///
 /// \see DecompressInto()
 template <typename Buffer = std::vector<std::byte>>
-[[nodiscard]] auto Decompress(ByteSpan input) -> Result<Buffer> {
+[[nodiscard]] auto Decompress(ByteSpan input) -> Result<Buffer, CompactError> {
     Buffer b;
     Try(DecompressInto(b, input));
     return b;
 }
 }
 
+/// Sink that compresses data before passing it on to another sink.
+///
+/// Data is collected into blocks, each of which is compressed as a
+/// separate zstd frame, so only a single block has to be kept in
+/// memory. The output is a sequence of zstd frames, which can be
+/// read using a DecompressingSource, e.g.
+///
+/// \code
+///     auto file = Try(File::Open(path, fs::OpenMode::Write));
+///     CompressingSink sink{file};
+///     ser::Writer<std::endian::little> w{sink};
+///     w << value;
+///     Try(w.flush());
+///     Try(sink.flush());
+/// \endcode
+class base::CompressingSink {
+    LIBBASE_DECLARE_HIDDEN_IMPL_IMMOVABLE(
+        CompressingSink,
+        std::function<Result<>(ByteSpan)> sink,
+        usz block_size,
+        std::optional<int> compression_level,
+        bool checksums
+    );
+
+public:
+    /// Create a sink that writes compressed data to another sink; the
+    /// other sink must outlive this one.
+    ///
+    /// \param block_size How much data to compress at once.
+    /// \param compression_level See CompressInto().
+    /// \param checksums Whether to store a checksum of each block.
+    template <ser::Sink S>
+    explicit CompressingSink(
+        S& sink,
+        usz block_size = DefaultCompressionBlockSize,
+        std::optional<int> compression_level = {},
+        bool checksums = true
+    ) : CompressingSink(
+            [&sink](ByteSpan bytes) -> Result<> { return sink.write(bytes); },
+            block_size,
+            compression_level,
+            checksums
+        ) {}
+
+    /// Compress any buffered data and write it to the sink.
+    ///
+    /// This always ends the current block, so calling this too often
+    /// makes the compression worse.
+    auto flush() -> Result<>;
+
+    /// Append data to the current block.
+    auto write(ByteSpan data) -> Result<>;
+};
+
+/// Source that decompresses data read from another source.
+///
+/// This reads zstd frames, e.g. ones written by a CompressingSink,
+/// and verifies their checksums, if present. Data is decompressed
+/// as it is read, so only a single chunk of the compressed data has
+/// to be kept in memory.
+class base::DecompressingSource {
+    LIBBASE_DECLARE_HIDDEN_IMPL_IMMOVABLE(
+        DecompressingSource,
+        std::function<Result<usz>(MutableByteSpan)> source,
+        usz chunk_size
+    );
+
+public:
+    /// Create a source that decompresses data read from another source
+    /// in chunks of 'chunk_size' bytes; the other source must outlive
+    /// this one.
+    template <ser::Source S>
+    explicit DecompressingSource(S& source, usz chunk_size = ser::DefaultChunkSize)
+        : DecompressingSource(
+            [&source](MutableByteSpan into) -> Result<usz> { return source.read(into); },
+            chunk_size
+        ) {}
+
+    /// Decompress data into a buffer.
+    auto read(MutableByteSpan into) -> Result<usz>;
+};
+
 #endif // LIBBASE_ENABLE_ZSTD
 
 #endif // LIBBASE_COMPRESSION_HH
@@ -0,0 +1,95 @@
+#ifndef LIBBASE_LINEINDEX_HH
+#define LIBBASE_LINEINDEX_HH
+
+#include <base/Assert.hh>
+#include <base/Str.hh>
+#include <base/Types.hh>
+#include <algorithm>
+#include <ranges>
+#include <vector>
+
+namespace base {
+template <typename OffsetType>
+class BasicLineIndex;
+
+using LineIndex = BasicLineIndex<u64>;
+using LineIndex32 = BasicLineIndex<u32>;
+}
+
+/// Index of the lines in a text.
+///
+/// This records the offset of the start of every line in one pass over
+/// the text, which allows for constant-time access to any line, e.g. to
+/// jump to a line number in a large file. The lines are the same as those
+/// yielded by str::lines().
+///
+/// Use 'LineIndex32' to halve the size of the index if the text is known
+/// to be smaller than 4 GiB.
+///
+/// The index does not copy the text, so the text must outlive it.
+template <typename OffsetType>
+class base::BasicLineIndex {
+    static_assert(
+        std::is_same_v<OffsetType, u32> or std::is_same_v<OffsetType, u64>,
+        "Offset type must be u32 or u64"
+    );
+
+    str data;
+    std::vector<OffsetType> starts;
+
+public:
+    /// Create an empty index.
+    BasicLineIndex() = default;
+
+    /// Build an index for a text.
+    ///
+    /// If 'threads' is greater than 1, large texts are split into chunks
+    /// that are scanned in parallel; pass 0 to use one thread per core.
+    explicit BasicLineIndex(str text, usz threads = 1);
+
+    /// Check if there are no lines.
+    [[nodiscard]] auto empty() const -> bool { return starts.empty(); }
+
+    /// Get a line by index.
+    [[nodiscard]] auto line(usz n) const -> str {
+        Assert(n < size(), "Line index {} out of bounds (size: {})", n, size());
+        auto start = usz(starts[n]);
+        auto end = n + 1 < size() ? usz(starts[n + 1]) - 1 : data.size();
+        return data.slice(start, end - start);
+    }
+
+    /// Find the line that contains a character.
+    ///
+    /// An offset that is equal to the size of the text is considered
+    /// part of the last line.
+    [[nodiscard]] auto line_containing(usz offset) const -> usz {
+        Assert(not empty() and offset <= data.size(), "Offset {} out of bounds", offset);
+        auto it = rgs::upper_bound(starts, offset, {}, [](OffsetType o) { return usz(o); });
+        return usz(it - starts.begin()) - 1;
+    }
+
+    /// Iterate over all lines.
+    [[nodiscard]] auto lines() const {
+        return vws::iota(usz(0), size()) | vws::transform([this](usz n) { return line(n); });
+    }
+
+    /// Get the offset of the start of a line in the text.
+    [[nodiscard]] auto offset(usz n) const -> usz {
+        Assert(n < size(), "Line index {} out of bounds (size: {})", n, size());
+        return usz(starts[n]);
+    }
+
+    /// Get the number of lines.
+    [[nodiscard]] auto size() const -> usz { return starts.size(); }
+
+    /// Get the text that this indexes.
+    [[nodiscard]] auto text() const -> str { return data; }
+
+    /// Get a line by index.
+    [[nodiscard]] auto operator[](usz n) const -> str { return line(n); }
+};
+
+extern template class base::BasicLineIndex<u32>;
+extern template class base::BasicLineIndex<u64>;
+
+#endif // LIBBASE_LINEINDEX_HH
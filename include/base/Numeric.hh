@@ -46,29 +46,32 @@ template <std::integral T>
 }
 
 /// Parse a 'Ty' from a string.
+///
+/// This doesn’t allocate if parsing fails unless the error message
+/// is requested.
 template <typename Ty>
-auto Parse(std::string_view sv) noexcept -> Result<Ty> = delete;
+auto Parse(std::string_view sv) noexcept -> Result<Ty, CompactError> = delete;
 
 /// Bool parser.
-template <> auto Parse<bool>(std::string_view sv) noexcept -> Result<bool>;
+template <> auto Parse<bool>(std::string_view sv) noexcept -> Result<bool, CompactError>;
 
 /// Integer parsers.
-template <> auto Parse<i8>(std::string_view sv) noexcept -> Result<i8>;
-template <> auto Parse<i16>(std::string_view sv) noexcept -> Result<i16>;
-template <> auto Parse<i32>(std::string_view sv) noexcept -> Result<i32>;
-template <> auto Parse<i64>(std::string_view sv) noexcept -> Result<i64>;
-template <> auto Parse<u8>(std::string_view sv) noexcept -> Result<u8>;
-template <> auto Parse<u16>(std::string_view sv) noexcept -> Result<u16>;
-template <> auto Parse<u32>(std::string_view sv) noexcept -> Result<u32>;
-template <> auto Parse<u64>(std::string_view sv) noexcept -> Result<u64>;
+template <> auto Parse<i8>(std::string_view sv) noexcept -> Result<i8, CompactError>;
+template <> auto Parse<i16>(std::string_view sv) noexcept -> Result<i16, CompactError>;
+template <> auto Parse<i32>(std::string_view sv) noexcept -> Result<i32, CompactError>;
+template <> auto Parse<i64>(std::string_view sv) noexcept -> Result<i64, CompactError>;
+template <> auto Parse<u8>(std::string_view sv) noexcept -> Result<u8, CompactError>;
+template <> auto Parse<u16>(std::string_view sv) noexcept -> Result<u16, CompactError>;
+template <> auto Parse<u32>(std::string_view sv) noexcept -> Result<u32, CompactError>;
+template <> auto Parse<u64>(std::string_view sv) noexcept -> Result<u64, CompactError>;
 
 /// Floating-point parsers.
-template <> auto Parse<f32>(std::string_view sv) noexcept -> Result<f32>;
-template <> auto Parse<f64>(std::string_view sv) noexcept -> Result<f64>;
+template <> auto Parse<f32>(std::string_view sv) noexcept -> Result<f32, CompactError>;
+template <> auto Parse<f64>(std::string_view sv) noexcept -> Result<f64, CompactError>;
 
 #ifdef LIBBASE_I128_AVAILABLE
-template <> auto Parse<i128>(std::string_view sv) noexcept -> Result<i128>;
-template <> auto Parse<u128>(std::string_view sv) noexcept -> Result<u128>;
+template <> auto Parse<i128>(std::string_view sv) noexcept -> Result<i128, CompactError>;
+template <> auto Parse<u128>(std::string_view sv) noexcept -> Result<u128, CompactError>;
 #endif
 } // namespace base
 
@@ -1,9 +1,14 @@
 #ifndef LIBBASE_RESULT_HH
 #define LIBBASE_RESULT_HH
 
+#include <array>
+#include <cstring>
 #include <expected>
 #include <format>
+#include <memory>
 #include <string>
+#include <system_error>
+#include <tuple>
 #include <type_traits>
 #include <base/Utils.hh>
 
@@ -30,33 +35,245 @@ concept Reference = std::is_reference_v<Ty>;
 template <typename Ty>
 concept NotReference = not Reference<Ty>;
 
-template <typename Ty>
+template <typename Ty, typename Err>
 struct ResultImpl;
 
-template <Reference Ty>
-struct ResultImpl<Ty> {
-    using type = std::expected<ReferenceWrapper<std::remove_reference_t<Ty>>, std::string>;
+template <Reference Ty, typename Err>
+struct ResultImpl<Ty, Err> {
+    using type = std::expected<ReferenceWrapper<std::remove_reference_t<Ty>>, Err>;
 };
 
-template <NotReference Ty>
-struct ResultImpl<Ty> {
-    using type = std::expected<Ty, std::string>;
+template <NotReference Ty, typename Err>
+struct ResultImpl<Ty, Err> {
+    using type = std::expected<Ty, Err>;
 };
 
-template <typename Ty>
-struct ResultImpl<std::reference_wrapper<Ty>> {
-    using type = typename ResultImpl<Ty&>::type;
+template <typename Ty, typename Err>
+struct ResultImpl<std::reference_wrapper<Ty>, Err> {
+    using type = typename ResultImpl<Ty&, Err>::type;
     static_assert(false, "Use Result<T&> instead of Result<reference_wrapper<T>>");
 };
 
-template <typename Ty>
-struct ResultImpl<ReferenceWrapper<Ty>> {
-    using type = typename ResultImpl<Ty&>::type;
+template <typename Ty, typename Err>
+struct ResultImpl<ReferenceWrapper<Ty>, Err> {
+    using type = typename ResultImpl<Ty&, Err>::type;
     static_assert(false, "Use Result<T&> instead of Result<ReferenceWrapper<T>>");
 };
+
+/// Get the message of an error so we can throw it.
+template <typename Err>
+auto ErrorMessage(const Err& err) -> decltype(auto) {
+    if constexpr (std::convertible_to<const Err&, std::string_view>) return (err);
+    else return std::string(err);
+}
+
+/// Arguments of a CompactError that are copied into it as strings.
+template <typename Ty>
+concept CompactErrorString = std::convertible_to<const Ty&, std::string_view>;
+
+/// Types that can be used as arguments of a CompactError.
+template <typename Ty>
+concept CompactErrorArg = std::is_arithmetic_v<Ty> or std::same_as<Ty, std::errc> or CompactErrorString<Ty>;
+
+/// The type an argument of a CompactError is formatted as.
+template <typename Ty>
+using CompactErrorFormatArg = std::conditional_t<
+    std::same_as<Ty, std::errc>,
+    std::string,
+    std::conditional_t<CompactErrorString<Ty>, std::string_view, Ty>
+>;
 } // namespace base::detail
 
 namespace base {
+/// The kind of error stored in a CompactError.
+enum class ErrorCode : u8 {
+    /// Any other error.
+    Other,
+
+    /// The input ended before we were done reading it.
+    NotEnoughData,
+
+    /// The input is malformed.
+    InvalidInput,
+
+    /// A value does not fit in the type it is read into.
+    OutOfRange,
+};
+
+/// An error that can be created without allocating memory.
+///
+/// Instead of a message, this stores an error code along with the
+/// format string and arguments of the message, which is only formatted
+/// once someone asks for it. Arguments must be arithmetic types, strings,
+/// or 'std::errc'; strings are copied into the error, and if they don’t
+/// fit, the message is formatted right away instead.
+///
+/// Use this as the error type of a Result on hot paths where callers
+/// may handle the error without ever looking at the message:
+///
+/// \code
+///     auto Read(usz n) -> Result<ByteSpan, CompactError> {
+///         if (n > size) return Error(ErrorCode::NotEnoughData, "Need {} bytes", n);
+///         ...
+///     }
+/// \endcode
+///
+/// A CompactError converts to and from 'std::string', so a function
+/// that returns a Result<T> can Try() or return a Result<T, CompactError>
+/// as usual.
+class CompactError {
+    using Formatter = auto (*)(std::string_view fmt, const std::byte* args) -> std::string;
+
+    /// Size of the storage for the arguments of the message.
+    static constexpr usz StorageSize = 16;
+    static_assert(StorageSize <= 255, "String arguments are stored with a one-byte length");
+
+    /// A message that is yet to be formatted.
+    struct Lazy {
+        std::string_view format;
+        std::array<std::byte, StorageSize> storage;
+    };
+
+    /// Only one of these is active: 'lazy' if we have a formatter, and
+    /// 'formatted' otherwise; this keeps errors about as small as a string.
+    union {
+        Lazy lazy;
+        std::string formatted;
+    };
+
+    Formatter formatter = nullptr;
+    ErrorCode error_code;
+
+public:
+    /// Create an error from a message.
+    CompactError(std::string message, ErrorCode code = ErrorCode::Other)
+        : formatted{std::move(message)}, error_code{code} {}
+
+    /// Create an error whose message is formatted lazily.
+    template <typename... Args>
+    requires (detail::CompactErrorArg<std::decay_t<Args>> and ...)
+    CompactError(
+        ErrorCode code,
+        std::format_string<detail::CompactErrorFormatArg<std::decay_t<Args>>...> fmt,
+        Args&&... args
+    ) : lazy{.format = fmt.get(), .storage = {}}, error_code{code} {
+        usz size = 0;
+        bool fits = true;
+        auto Store = [&](const void* data, usz n) {
+            if (not fits or n > StorageSize - size) {
+                fits = false;
+                return;
+            }
+
+            std::memcpy(lazy.storage.data() + size, data, n);
+            size += n;
+        };
+
+        auto StoreArg = [&]<typename Ty>(const Ty& arg) {
+            if constexpr (detail::CompactErrorString<Ty>) {
+                std::string_view s = arg;
+                if (s.size() > StorageSize) {
+                    fits = false;
+                    return;
+                }
+
+                auto n = u8(s.size());
+                Store(&n, sizeof n);
+                Store(s.data(), n);
+            } else {
+                Store(&arg, sizeof arg);
+            }
+        };
+
+        (StoreArg(args), ...);
+        if (fits) formatter = &FormatStored<std::decay_t<Args>...>;
+        else std::construct_at(&formatted, Format(fmt.get(), FormatArg(args)...));
+    }
+
+    CompactError(const CompactError& other) : error_code{other.error_code} {
+        if (other.formatter) std::construct_at(&lazy, other.lazy);
+        else std::construct_at(&formatted, other.formatted);
+        formatter = other.formatter;
+    }
+
+    CompactError(CompactError&& other) noexcept : error_code{other.error_code} {
+        if (other.formatter) std::construct_at(&lazy, other.lazy);
+        else std::construct_at(&formatted, std::move(other.formatted));
+        formatter = other.formatter;
+    }
+
+    auto operator=(const CompactError& other) -> CompactError& {
+        if (this != &other) *this = CompactError(other);
+        return *this;
+    }
+
+    auto operator=(CompactError&& other) noexcept -> CompactError& {
+        if (this == &other) return *this;
+        if (not formatter) std::destroy_at(&formatted);
+        if (other.formatter) std::construct_at(&lazy, other.lazy);
+        else std::construct_at(&formatted, std::move(other.formatted));
+        formatter = other.formatter;
+        error_code = other.error_code;
+        return *this;
+    }
+
+    ~CompactError() {
+        if (not formatter) std::destroy_at(&formatted);
+    }
+
+    /// Get the error code.
+    [[nodiscard]] auto code() const -> ErrorCode { return error_code; }
+
+    /// Get the error message.
+    [[nodiscard]] auto message() const -> std::string {
+        if (formatter) return formatter(lazy.format, lazy.storage.data());
+        return formatted;
+    }
+
+    /// Get the error message.
+    operator std::string() const { return message(); }
+
+    /// Compare the error message to a string.
+    friend auto operator==(const CompactError& e, std::string_view message) -> bool {
+        return e.message() == message;
+    }
+
+private:
+    template <typename... Args>
+    static auto Format(std::string_view fmt, Args... args) -> std::string {
+        return std::vformat(fmt, std::make_format_args(args...));
+    }
+
+    template <typename Ty>
+    static auto FormatArg(const Ty& arg) -> detail::CompactErrorFormatArg<std::decay_t<Ty>> {
+        if constexpr (std::same_as<Ty, std::errc>) return std::make_error_code(arg).message();
+        else return arg;
+    }
+
+    template <typename... Args>
+    static auto FormatStored(std::string_view fmt, const std::byte* args) -> std::string {
+        auto Load = [&]<typename Ty>(std::type_identity<Ty>) -> detail::CompactErrorFormatArg<Ty> {
+            if constexpr (detail::CompactErrorString<Ty>) {
+                auto n = u8(*args);
+                std::string_view s{reinterpret_cast<const char*>(args + 1), n};
+                args += 1 + n;
+                return s;
+            } else {
+                Ty arg;
+                std::memcpy(&arg, args, sizeof arg);
+                args += sizeof arg;
+                return FormatArg(arg);
+            }
+        };
+
+        // Braced initialisation ensures the arguments are loaded in order.
+        return std::apply(
+            [&](auto... loaded) { return Format(fmt, loaded...); },
+            std::tuple<detail::CompactErrorFormatArg<Args>...>{Load(std::type_identity<Args>{})...}
+        );
+    }
+};
+
 /// A result type that stores either a value or an error message.
 ///
 /// You can create a new result using the 'Error()' function and
@@ -64,12 +281,22 @@ namespace base {
 /// want to handle the error).
 ///
 /// Result<T&> is valid and is handled correctly.
-template <typename T = void>
-class [[nodiscard]] Result : public detail::ResultImpl<T>::type {
-    using Base = detail::ResultImpl<T>::type;
+///
+/// The error type is 'std::string' by default; use 'CompactError' on
+/// hot paths that shouldn’t allocate if they fail. Results with different
+/// error types convert to one another if their error types do.
+template <typename T = void, typename Err = std::string>
+class [[nodiscard]] Result : public detail::ResultImpl<T, Err>::type {
+    using Base = detail::ResultImpl<T, Err>::type;
+    template <typename, typename> friend class Result;
 
 public:
-    using detail::ResultImpl<T>::type::type;
+    using detail::ResultImpl<T, Err>::type::type;
+
+    /// Convert a result with a different error type.
+    template <typename E>
+    requires (not std::same_as<E, Err> and std::convertible_to<E, Err>)
+    Result(Result<T, E> other) : Base{Convert(std::move(other))} {}
 
     /// Disallow unchecked operations.
     auto operator*() = delete;
@@ -77,7 +304,7 @@ public:
 
     /// Throw an error if this doesn’t store a value.
     void check() {
-        if (not this->has_value()) utils::ThrowOrAbort(this->error());
+        if (not this->has_value()) utils::ThrowOrAbort(detail::ErrorMessage(this->error()));
     }
 
     /// Get the value or throw the error.
@@ -89,15 +316,24 @@ public:
         not std::is_reference_v<T>
     ) {
         if (self.has_value()) return std::forward<Self>(self).Base::value();
-        utils::ThrowOrAbort(std::forward<Self>(self).error());
+        utils::ThrowOrAbort(detail::ErrorMessage(self.error()));
     }
 
     auto value() -> detail::ReferenceWrapper<std::remove_reference_t<T>> requires std::is_reference_v<T> {
         if (this->has_value()) return this->Base::value();
-        utils::ThrowOrAbort(this->error());
+        utils::ThrowOrAbort(detail::ErrorMessage(this->error()));
     }
 
     void value() requires std::is_void_v<T> { check(); }
+
+private:
+    template <typename E>
+    static auto Convert(Result<T, E>&& other) -> Base {
+        using Other = detail::ResultImpl<T, E>::type;
+        if (not other.has_value()) return Base{std::unexpect, std::move(other).error()};
+        if constexpr (std::is_void_v<T>) return Base{};
+        else return Base{std::in_place, std::move(other).Other::value()};
+    }
 };
 
 /// Create an error message.
@@ -108,6 +344,19 @@ template <typename... Args>
 ) -> std::unexpected<std::string> {
     return std::unexpected(std::format(fmt, std::forward<Args>(args)...));
 }
+
+/// Create an error whose message is only formatted if it is needed.
+///
+/// \see CompactError
+template <typename... Args>
+requires (detail::CompactErrorArg<std::decay_t<Args>> and ...)
+[[nodiscard]] auto Error(
+    ErrorCode code,
+    std::format_string<detail::CompactErrorFormatArg<std::decay_t<Args>>...> fmt,
+    Args&&... args
+) -> std::unexpected<CompactError> {
+    return std::unexpected(CompactError(code, fmt, std::forward<Args>(args)...));
+}
 } // namespace base
 
 #endif // LIBBASE_RESULT_HH
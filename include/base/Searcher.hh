@@ -0,0 +1,110 @@
+#ifndef LIBBASE_SEARCHER_HH
+#define LIBBASE_SEARCHER_HH
+
+#include <algorithm>
+#include <array>
+#include <base/Types.hh>
+#include <string_view>
+#include <type_traits>
+
+namespace base {
+template <typename CharType>
+class basic_searcher;
+
+using searcher = basic_searcher<char>;
+using u8searcher = basic_searcher<char8_t>;
+using u16searcher = basic_searcher<char16_t>;
+using u32searcher = basic_searcher<char32_t>;
+
+namespace detail {
+/// Find a byte string in another byte string.
+///
+/// 'skip' is the Horspool shift table of the needle.
+auto FindSubstring(
+    const char* haystack,
+    usz haystack_size,
+    const char* needle,
+    usz needle_size,
+    const u8* skip
+) noexcept -> usz;
+}
+}
+
+/// Precomputed substring search.
+///
+/// Use this instead of passing the same string to str::first(), count(),
+/// replace(), etc. over and over again; the searcher only preprocesses the
+/// needle once.
+///
+/// For byte strings, this uses a vectorised filter that looks for the first
+/// and last character of the needle at the same time, if possible, and the
+/// Boyer-Moore-Horspool algorithm otherwise.
+///
+/// The searcher does not copy the needle, so the needle must outlive it.
+template <typename CharType>
+class base::basic_searcher {
+public:
+    using char_type = CharType;
+    using text_type = std::basic_string_view<char_type>;
+    static constexpr usz npos = text_type::npos;
+
+private:
+    /// The string we’re looking for.
+    text_type needle;
+
+    /// Horspool shift table, indexed by the low byte of a character; shifts
+    /// are clamped to 255 since a shorter shift is always safe.
+    std::array<u8, 256> skip{};
+
+    static constexpr auto Key(char_type c) -> usz {
+        return usz(std::make_unsigned_t<char_type>(c)) & 0xFF;
+    }
+
+public:
+    /// Create a searcher for a string.
+    constexpr explicit basic_searcher(text_type needle) : needle{needle} {
+        skip.fill(u8(std::min<usz>(needle.size(), 255)));
+        for (usz i = 0; i + 1 < needle.size(); i++)
+            skip[Key(needle[i])] = u8(std::min<usz>(needle.size() - 1 - i, 255));
+    }
+
+    /// Find the first occurrence of the needle in a string, starting at 'from'.
+    ///
+    /// \return The index of the occurrence, or 'npos' if there is none.
+    [[nodiscard]] constexpr auto find(text_type haystack, usz from = 0) const -> usz {
+        if (from > haystack.size()) return npos;
+        if (needle.empty()) return from;
+        if (needle.size() > haystack.size() - from) return npos;
+        if !consteval {
+            if constexpr (sizeof(char_type) == 1) {
+                auto pos = detail::FindSubstring(
+                    reinterpret_cast<const char*>(haystack.data()) + from,
+                    haystack.size() - from,
+                    reinterpret_cast<const char*>(needle.data()),
+                    needle.size(),
+                    skip.data()
+                );
+
+                return pos == npos ? npos : pos + from;
+            }
+        }
+
+        const auto m = needle.size();
+        const auto last = needle.back();
+        for (usz i = from; i + m <= haystack.size();) {
+            auto c = haystack[i + m - 1];
+            if (c == last and haystack.substr(i, m - 1) == needle.substr(0, m - 1)) return i;
+            i += skip[Key(c)];
+        }
+
+        return npos;
+    }
+
+    /// Get the length of the needle.
+    [[nodiscard]] constexpr auto size() const -> usz { return needle.size(); }
+
+    /// Get the needle.
+    [[nodiscard]] constexpr auto text() const -> text_type { return needle; }
+};
+
+#endif // LIBBASE_SEARCHER_HH
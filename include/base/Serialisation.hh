@@ -7,18 +7,44 @@
 #include <base/StringUtils.hh>
 #include <base/Types.hh>
 #include <base/Utils.hh>
+#include <bit>
+#include <concepts>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <optional>
 #include <span>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <variant>
 #include <vector>
 
 #define LIBBASE_SERIALISE(Class, ...)                                                                      \
-    template <std::endian E> friend class ::base::ser::Reader;                                             \
-    template <std::endian E> friend class ::base::ser::Writer;                                             \
-    template <std::endian E> void serialise(::base::ser::Writer<E>& w) const { w(__VA_ARGS__); }           \
-    template <std::endian E> static auto deserialise(::base::ser::Reader<E>& r) -> Result<Class> {         \
+    template <std::endian, ::base::ser::Encoding> friend class ::base::ser::Reader;                        \
+    template <std::endian, ::base::ser::Encoding> friend class ::base::ser::Writer;                        \
+    template <typename> friend struct ::base::detail::PackedStruct;                                        \
+    static auto _libbase_serialised_fields() {                                                             \
+        return std::type_identity<decltype(std::tuple(__VA_ARGS__))>{};                                    \
+    }                                                                                                      \
+    auto _libbase_packed_layout() const -> bool {                                                          \
+        return ::base::detail::IsPackedLayout(this, __VA_ARGS__);                                          \
+    }                                                                                                      \
+    template <std::endian E, ::base::ser::Encoding Enc>                                                    \
+    void serialise(::base::ser::Writer<E, Enc>& w) const {                                                 \
+        using Packed = ::base::detail::PackedStruct<Class>;                                                \
+        if constexpr (Packed::template Packable<Enc>()) {                                                  \
+            if (Packed::IsPacked()) return Packed::Write(w, this, 1);                                      \
+        }                                                                                                  \
+        w(__VA_ARGS__);                                                                                    \
+    }                                                                                                      \
+    template <std::endian E, ::base::ser::Encoding Enc>                                                    \
+    static auto deserialise(::base::ser::Reader<E, Enc>& r) -> Result<Class> {                             \
+        using Packed = ::base::detail::PackedStruct<Class>;                                                \
+        if constexpr (Packed::template Packable<Enc>()) {                                                  \
+            if (Packed::IsPacked()) return Packed::Read(r);                                                \
+        }                                                                                                  \
         return std::apply(                                                                                 \
             [](auto&&... args) {                                                                           \
                 if constexpr (requires { Class{::base::ser::deserialise_tag{}, LIBBASE_FWD(args)...}; }) { \
@@ -49,6 +75,12 @@
 /// exists whose first parameter is of type 'base::ser::deserialise_tag', then
 /// that constructor is called instead.
 ///
+/// If all fields are arithmetic types, and they are laid out in memory in
+/// the order in which they are listed, without padding and without any
+/// other members, then objects of the type are copied as a whole instead
+/// of field by field. Types that have a 'deserialise_tag' constructor are
+/// always deserialised by calling it.
+///
 /// If this is not possible, perhaps because the type in question is defined
 /// in another library, you can implement specialisations of Serialiser<T>
 /// for your type:
@@ -61,8 +93,24 @@
 namespace base::ser {
 struct deserialise_tag {};
 
-template <std::endian SerialisedEndianness>  class Reader;
-template <std::endian SerialisedEndianness>  class Writer;
+/// Tag for creating a Writer that only counts bytes.
+struct count_only_tag {};
+
+/// How integers are encoded.
+enum class Encoding : u8 {
+    /// Integers are stored at their full width.
+    Fixed,
+
+    /// Integers (including sizes) are stored as LEB128 varints. Signed
+    /// integers are zigzag-encoded so small negative values stay small.
+    ///
+    /// Bytes, characters, and floating-point values are stored the same
+    /// way as with 'Fixed'.
+    Varint,
+};
+
+template <std::endian SerialisedEndianness, Encoding SerialisedEncoding = Encoding::Fixed> class Reader;
+template <std::endian SerialisedEndianness, Encoding SerialisedEncoding = Encoding::Fixed> class Writer;
 
 using ReaderLE = Reader<std::endian::little>;
 using ReaderBE = Reader<std::endian::big>;
@@ -71,6 +119,44 @@ using WriterBE = Writer<std::endian::big>;
 
 using InputSpan [[deprecated("Use ByteSpan instead")]] = ByteSpan;
 
+/// Default size of the chunks in which a Reader or Writer transfers
+/// data from a source or to a sink.
+constexpr usz DefaultChunkSize = 64 * 1024;
+
+/// Anything serialised data can be written to, e.g. a 'fs::File'.
+template <typename T>
+concept Sink = requires (T& t, ByteSpan data) {
+    { t.write(data) } -> std::convertible_to<Result<>>;
+};
+
+/// Anything serialised data can be read from, e.g. a 'fs::File'.
+///
+/// 'read()' should read at most 'into.size()' bytes and return how
+/// many bytes it read; returning 0 means there is no more data.
+template <typename T>
+concept Source = requires (T& t, MutableByteSpan into) {
+    { t.read(into) } -> std::convertible_to<Result<usz>>;
+};
+
+/// Sink that writes to a fixed-size buffer.
+class SpanSink;
+
+/// Wrapper to serialise a range with an offset table.
+template <typename Range>
+struct Indexed;
+
+/// View of a range that was serialised with an offset table.
+template <typename T>
+class IndexedView;
+
+/// View of a map that was serialised with an offset table.
+template <typename Key, typename Value>
+class IndexedMapView;
+
+/// Wrapper to serialise a range on several threads.
+template <typename Range>
+struct Parallel;
+
 /// Magic number to check the serialised data is valid.
 /// TODO: Add this back and use a static_string template parameter for it.
 /*template <usz n>
@@ -109,20 +195,65 @@ struct Serialiser;
 /// Deserialise a type from a span of bytes.
 ///
 /// @tparam SerialisedEndianness The output endianness of the serialised data.
-template <typename T, std::endian SerialisedEndianness>
+/// @tparam SerialisedEncoding The encoding of integers in the serialised data.
+template <typename T, std::endian SerialisedEndianness, Encoding SerialisedEncoding = Encoding::Fixed>
 auto Deserialise(ByteSpan data) -> Result<T>;
 
+/// Deserialise a type from a source.
+///
+/// @tparam SerialisedEndianness The output endianness of the serialised data.
+/// @tparam SerialisedEncoding The encoding of integers in the serialised data.
+template <typename T, std::endian SerialisedEndianness, Encoding SerialisedEncoding = Encoding::Fixed, Source S>
+auto Deserialise(S& source) -> Result<T>;
+
 /// Serialise a type to a vector of bytes.
 ///
 /// @tparam SerialisedEndianness The input endianness of the serialised data.
-template <std::endian SerialisedEndianness, typename T>
+/// @tparam SerialisedEncoding The encoding of integers in the serialised data.
+template <std::endian SerialisedEndianness, Encoding SerialisedEncoding = Encoding::Fixed, typename T>
 void Serialise(std::vector<std::byte>& into, const T& t);
 
 /// Serialise a type to a new vector of bytes.
 ///
 /// @tparam SerialisedEndianness The input endianness of the serialised data.
-template <std::endian SerialisedEndianness, typename T>
+/// @tparam SerialisedEncoding The encoding of integers in the serialised data.
+template <std::endian SerialisedEndianness, Encoding SerialisedEncoding = Encoding::Fixed, typename T>
 auto Serialise(const T& t) -> std::vector<std::byte>;
+
+/// Serialise a type into a buffer.
+///
+/// Returns the number of bytes written, or an error if the buffer is
+/// too small.
+///
+/// @tparam SerialisedEndianness The input endianness of the serialised data.
+/// @tparam SerialisedEncoding The encoding of integers in the serialised data.
+template <std::endian SerialisedEndianness, Encoding SerialisedEncoding = Encoding::Fixed, typename T>
+auto Serialise(MutableByteSpan into, const T& t) -> Result<usz>;
+
+/// Get the number of bytes a value takes up when serialised.
+///
+/// For types whose serialised size doesn’t depend on the value, this
+/// is a constant (see FixedSerialisedSize); otherwise, the value is
+/// serialised without storing the data to compute its size.
+///
+/// @tparam SerialisedEncoding The encoding of integers in the serialised data.
+/// @tparam SerialisedEndianness The endianness does not affect the size, but
+///         some types may only support serialising with one endianness.
+template <
+    Encoding SerialisedEncoding = Encoding::Fixed,
+    std::endian SerialisedEndianness = std::endian::native,
+    typename T
+> auto SerialisedSize(const T& t) -> usz;
+
+/// Serialise a type to a sink.
+///
+/// Unlike the other overloads, this doesn’t keep the entire serialised
+/// data in memory, but writes it to the sink in chunks.
+///
+/// @tparam SerialisedEndianness The input endianness of the serialised data.
+/// @tparam SerialisedEncoding The encoding of integers in the serialised data.
+template <std::endian SerialisedEndianness, Encoding SerialisedEncoding = Encoding::Fixed, Sink S, typename T>
+auto Serialise(S& sink, const T& t) -> Result<>;
 }
 
 // TODO: Pass version number to deserialise().
@@ -138,14 +269,41 @@ consteval bool CheckEndianness(std::endian e) {
 }
 
 /// Helper to deserialise objects.
-template <std::endian E>
+///
+/// A reader either reads from a buffer that contains all of the data,
+/// or from a source, in which case it reads the data in chunks.
+template <std::endian E, base::ser::Encoding Enc>
 class base::ser::Reader {
     static_assert(CheckEndianness(E));
+    LIBBASE_IMMOVABLE(Reader);
+
+    using SourceFn = std::function<Result<usz>(MutableByteSpan)>;
+
+    /// The data that hasn’t been read yet.
     ByteSpan data;
 
+    /// Function that reads more data; only set if we read from a source.
+    SourceFn source;
+
+    /// Buffer that holds the data read from the source.
+    std::vector<std::byte> buffer;
+    usz chunk_size = 0;
+
 public:
+    /// Create a reader that reads from a buffer.
     explicit Reader(ByteSpan data) : data(data) {}
 
+    /// Create a reader that reads from a source in chunks of at least
+    /// 'chunk_size' bytes; the source must outlive the reader.
+    template <Source S>
+    explicit Reader(S& source, usz chunk_size = DefaultChunkSize)
+        : Reader(SourceFn{[&source](MutableByteSpan into) -> Result<usz> { return source.read(into); }}, chunk_size) {}
+
+    /// Create a reader that calls a function to read more data.
+    ///
+    /// \see Source
+    explicit Reader(SourceFn source, usz chunk_size = DefaultChunkSize);
+
     /// Deserialise an object that provides a 'deserialise()' member.
     template <typename T, typename Self>
     requires requires (Self& self) { T::deserialise(self); }
@@ -169,30 +327,123 @@ public:
         return {};
     }
 
+    static constexpr auto encoding() -> Encoding { return Enc; }
     static constexpr auto endianness() -> std::endian { return E; }
 
+    /// Check whether this reader reads from a source.
+    [[nodiscard]] bool has_source() const { return bool(source); }
+
     /// Set the data buffer that this reader should read from.
-    void set_data(ByteSpan new_data) { data = new_data; }
+    ///
+    /// If this reader was reading from a source, it stops doing so.
+    void set_data(ByteSpan new_data) {
+        data = new_data;
+        source = nullptr;
+    }
 
     /// Check how many bytes are left in the buffer.
+    ///
+    /// If this reader reads from a source, this is only the number of
+    /// bytes that have already been read from the source.
     [[nodiscard]] auto size() const -> usz { return data.size(); }
 
     /// Read bytes from the buffer.
-    auto read_bytes(usz count) -> Result<ByteSpan>;
+    ///
+    /// If this reader reads from a source, the returned span is only
+    /// valid until the next call to a member function of Reader.
+    auto read_bytes(usz count) -> Result<ByteSpan, CompactError>;
 
     /// Read bytes into a memory location.
-    auto read_bytes_into(void* v, usz count) -> Result<>;
+    auto read_bytes_into(void* v, usz count) -> Result<void, CompactError>;
+
+    /// Read an LEB128 varint.
+    auto read_varint() -> Result<u64, CompactError>;
+
+    /// Read LEB128 varints until 'out' is full.
+    auto read_varints(std::span<u64> out) -> Result<void, CompactError>;
+
+private:
+    /// Read from the source until 'into' is full or there is no more data.
+    auto fill(MutableByteSpan into) -> Result<usz>;
+
+    /// Read from the source until at least 'count' bytes are buffered
+    /// or there is no more data.
+    auto refill(usz count) -> Result<>;
 };
 
 /// Helper to serialise objects.
-template <std::endian E>
+///
+/// A writer either appends everything to a vector, or writes to a sink,
+/// in which case it only buffers a chunk of data at a time.
+template <std::endian E, base::ser::Encoding Enc>
 class base::ser::Writer {
     static_assert(CheckEndianness(E));
+    LIBBASE_IMMOVABLE(Writer);
+
+    using SinkFn = std::function<Result<>(ByteSpan)>;
+
+    /// Where we write the data to.
+    enum class Mode : u8 {
+        Vector,
+        Sink,
+        Span,
+        Count,
+    };
+
+    /// Buffer for data that hasn’t been written to the sink yet, or
+    /// scratch memory if we don’t store the data.
+    std::vector<std::byte> buffer;
+
+    /// The vector we append to; this is 'buffer' unless we write to a
+    /// vector.
     std::vector<std::byte>& data;
 
+    /// Function that writes to the sink; only set if we write to one.
+    SinkFn sink;
+    usz chunk_size = 0;
+
+    /// The first error that occurred while writing to the sink or span.
+    Result<> status;
+
+    /// The part of the span that we haven’t written to yet.
+    MutableByteSpan out;
+
+    /// The number of bytes written so far.
+    usz total = 0;
+    Mode mode = Mode::Vector;
+
 public:
+    /// Create a writer that appends to a vector.
     explicit Writer(std::vector<std::byte>& data) : data(data) {}
 
+    /// Create a writer that writes to a fixed-size buffer.
+    ///
+    /// Writing more data than fits into the buffer is an error, which
+    /// is reported by flush().
+    explicit Writer(MutableByteSpan into) : data(buffer), out(into), mode(Mode::Span) {}
+
+    /// Create a writer that discards all data and only counts how many
+    /// bytes are written to it.
+    ///
+    /// \see written()
+    explicit Writer(count_only_tag) : data(buffer), mode(Mode::Count) {}
+
+    /// Create a writer that writes to a sink in chunks of (usually) at
+    /// most 'chunk_size' bytes; the sink must outlive the writer.
+    ///
+    /// Any remaining data is written to the sink when the writer is
+    /// destroyed, but errors can only be observed by calling flush().
+    template <Sink S>
+    explicit Writer(S& sink, usz chunk_size = DefaultChunkSize)
+        : Writer(SinkFn{[&sink](ByteSpan bytes) -> Result<> { return sink.write(bytes); }}, chunk_size) {}
+
+    /// Create a writer that passes each chunk to a function.
+    ///
+    /// \see Sink
+    explicit Writer(SinkFn sink, usz chunk_size = DefaultChunkSize);
+
+    ~Writer();
+
     /// Write several fields to this buffer.
     template <typename... Fields>
     void operator()(Fields&&... fields) {
@@ -233,34 +484,682 @@ public:
     /// Append raw bytes.
     void append_bytes(const void* ptr, usz count);
 
+    static constexpr auto encoding() -> Encoding { return Enc; }
     static constexpr auto endianness() -> std::endian { return E; }
+
+    /// Write any buffered data to the sink.
+    ///
+    /// Returns the first error that occurred while writing to the sink
+    /// or span. This does nothing if this writer doesn’t write to a sink.
+    auto flush() -> Result<>;
+
+    /// Check if this writer only counts how many bytes are written.
+    [[nodiscard]] auto counting() const -> bool { return mode == Mode::Count; }
+
+    /// Get the number of bytes written to this writer so far.
+    [[nodiscard]] auto written() const -> usz { return total; }
+
+private:
+    void flush_buffer();
+    void overflow(usz count);
+};
+
+/// Sink that writes to a fixed-size buffer.
+///
+/// Writing more data than fits into the buffer is an error.
+class base::ser::SpanSink {
+    MutableByteSpan buffer;
+    usz pos = 0;
+
+public:
+    explicit SpanSink(MutableByteSpan buffer) : buffer(buffer) {}
+
+    /// Get the part of the buffer that has been written to.
+    [[nodiscard]] auto written() const -> MutableByteSpan { return {buffer.data(), pos}; }
+
+    /// Append data to the buffer.
+    auto write(ByteSpan bytes) -> Result<>;
 };
 
-extern template class base::ser::Reader<std::endian::little>;
-extern template class base::ser::Reader<std::endian::big>;
+extern template class base::ser::Reader<std::endian::little, base::ser::Encoding::Fixed>;
+extern template class base::ser::Reader<std::endian::big, base::ser::Encoding::Fixed>;
+extern template class base::ser::Reader<std::endian::little, base::ser::Encoding::Varint>;
+extern template class base::ser::Reader<std::endian::big, base::ser::Encoding::Varint>;
 
-extern template class base::ser::Writer<std::endian::little>;
-extern template class base::ser::Writer<std::endian::big>;
+extern template class base::ser::Writer<std::endian::little, base::ser::Encoding::Fixed>;
+extern template class base::ser::Writer<std::endian::big, base::ser::Encoding::Fixed>;
+extern template class base::ser::Writer<std::endian::little, base::ser::Encoding::Varint>;
+extern template class base::ser::Writer<std::endian::big, base::ser::Encoding::Varint>;
 
-template <typename T, std::endian SerialisedEndianness>
+template <typename T, std::endian SerialisedEndianness, base::ser::Encoding SerialisedEncoding>
 auto base::ser::Deserialise(ByteSpan data) -> Result<T> {
-    Reader<SerialisedEndianness> r{data};
+    Reader<SerialisedEndianness, SerialisedEncoding> r{data};
     return r.template read<T>();
 }
 
-template <std::endian SerialisedEndianness, typename T>
+template <typename T, std::endian SerialisedEndianness, base::ser::Encoding SerialisedEncoding, base::ser::Source S>
+auto base::ser::Deserialise(S& source) -> Result<T> {
+    Reader<SerialisedEndianness, SerialisedEncoding> r{source};
+    return r.template read<T>();
+}
+
+template <std::endian SerialisedEndianness, base::ser::Encoding SerialisedEncoding, typename T>
 auto base::ser::Serialise(const T& t) -> std::vector<std::byte> {
     std::vector<std::byte> vec;
-    ser::Serialise<SerialisedEndianness>(vec, t);
+    ser::Serialise<SerialisedEndianness, SerialisedEncoding>(vec, t);
     return vec;
 }
 
-template <std::endian SerialisedEndianness, typename T>
+template <std::endian SerialisedEndianness, base::ser::Encoding SerialisedEncoding, typename T>
 void base::ser::Serialise(std::vector<std::byte>& into, const T& t) {
-    Writer<SerialisedEndianness> w{into};
+    // Allocate all the memory we need at once; if we’re appending to the
+    // vector repeatedly, keep growing it geometrically.
+    auto size = into.size() + SerialisedSize<SerialisedEncoding, SerialisedEndianness>(t);
+    if (size > into.capacity()) into.reserve(std::max(size, into.capacity() * 2));
+
+    Writer<SerialisedEndianness, SerialisedEncoding> w{into};
     w << t;
 }
 
+template <std::endian SerialisedEndianness, base::ser::Encoding SerialisedEncoding, typename T>
+auto base::ser::Serialise(MutableByteSpan into, const T& t) -> Result<usz> {
+    Writer<SerialisedEndianness, SerialisedEncoding> w{into};
+    w << t;
+    Try(w.flush());
+    return w.written();
+}
+
+template <std::endian SerialisedEndianness, base::ser::Encoding SerialisedEncoding, base::ser::Sink S, typename T>
+auto base::ser::Serialise(S& sink, const T& t) -> Result<> {
+    Writer<SerialisedEndianness, SerialisedEncoding> w{sink};
+    w << t;
+    return w.flush();
+}
+
+/// ====================================================================
+///  Varints
+/// ====================================================================
+namespace base::detail {
+/// Maximum size of an LEB128-encoded 64-bit integer.
+constexpr usz MaxVarintSize = 10;
+
+/// Types that are encoded as varints if the encoding is 'Varint'.
+template <typename T>
+concept VarintEncodable = std::integral<T>
+                      and sizeof(T) > 1
+                      and not utils::is_same<T, bool, char16_t, char32_t, wchar_t>;
+
+/// Check if a type is encoded as a varint in an encoding.
+template <typename T>
+constexpr bool IsVarint(ser::Encoding enc) {
+    return VarintEncodable<T> and enc == ser::Encoding::Varint;
+}
+
+/// Decode varints until 'out' is full or the rest of 'in' is an
+/// incomplete varint.
+///
+/// Returns the number of values decoded and sets 'consumed' to the
+/// number of bytes that they took up.
+auto DecodeVarints(ByteSpan in, std::span<u64> out, usz& consumed) -> Result<usz, CompactError>;
+
+/// Encode a value as a varint.
+///
+/// 'out' must have room for MaxVarintSize bytes. Returns the number of
+/// bytes written.
+constexpr auto EncodeVarint(u64 val, std::byte* out) -> usz {
+    usz i = 0;
+    for (; val >= 0x80; val >>= 7) out[i++] = std::byte(val | 0x80);
+    out[i++] = std::byte(val);
+    return i;
+}
+
+/// Map an integer to the value we encode as a varint.
+template <VarintEncodable T>
+constexpr auto ToVarint(T val) -> u64 {
+    if constexpr (std::is_signed_v<T>) return u64(i64(val)) << 1 ^ u64(i64(val) >> 63);
+    else return u64(val);
+}
+
+/// Map a decoded varint back to an integer.
+template <VarintEncodable T>
+auto FromVarint(u64 val) -> Result<T> {
+    if constexpr (std::is_signed_v<T>) {
+        auto s = i64(val >> 1) ^ -i64(val & 1);
+        if (s < std::numeric_limits<T>::min() or s > std::numeric_limits<T>::max()) [[unlikely]]
+            return Error("Value {} does not fit in a {}-bit integer", s, sizeof(T) * 8);
+        return T(s);
+    } else {
+        if (val > std::numeric_limits<T>::max()) [[unlikely]]
+            return Error("Value {} does not fit in a {}-bit integer", val, sizeof(T) * 8);
+        return T(val);
+    }
+}
+
+/// Read 'count' varints into 'out'.
+template <VarintEncodable T>
+auto ReadVarints(auto& r, T* out, usz count) -> Result<> {
+    if constexpr (std::same_as<T, u64>) {
+        return r.read_varints(std::span{out, count});
+    } else {
+        std::array<u64, 256> buf;
+        for (usz i = 0; i < count; i += buf.size()) {
+            auto n = std::min(count - i, buf.size());
+            Try(r.read_varints(std::span{buf.data(), n}));
+            for (usz j = 0; j < n; j++) out[i + j] = Try(FromVarint<T>(buf[j]));
+        }
+        return {};
+    }
+}
+
+/// Write 'count' values as varints.
+template <VarintEncodable T>
+void WriteVarints(auto& w, const T* in, usz count) {
+    std::array<std::byte, 1024> buf;
+    usz pos = 0;
+    for (usz i = 0; i < count; i++) {
+        if (pos + MaxVarintSize > buf.size()) {
+            w.append_bytes(buf.data(), pos);
+            pos = 0;
+        }
+
+        pos += EncodeVarint(ToVarint(in[i]), buf.data() + pos);
+    }
+
+    w.append_bytes(buf.data(), pos);
+}
+} // namespace base::detail
+
+/// ====================================================================
+///  Bulk Serialisation
+/// ====================================================================
+namespace base::detail {
+/// Types whose serialised form is their object representation, in
+/// the serialised byte order, or a varint.
+///
+/// Sequences of these can be (de)serialised with a single copy, plus
+/// a byte swap if the serialised endianness isn’t the native one, or
+/// by decoding a run of varints.
+template <typename T>
+concept BulkSerialisable = (std::integral<T> or std::same_as<T, float> or std::same_as<T, double>)
+                       and not std::same_as<T, bool>
+                       and not std::same_as<T, wchar_t>;
+
+/// Reverse the byte order of 'count' values of size 'size' in place.
+void ByteSwap(void* data, usz count, usz size);
+
+template <typename Class>
+struct PackedStruct;
+
+/// Types whose sequences can be read and written with ReadBulk() and
+/// WriteBulk() in an encoding.
+template <typename T, ser::Encoding Enc>
+concept BulkCopyable = BulkSerialisable<T> or PackedStruct<T>::template Packable<Enc>();
+
+/// Read 'count' values into 'out'.
+template <typename T>
+auto ReadBulk(auto& r, T* out, usz count) -> Result<> {
+    static_assert(BulkCopyable<T, r.encoding()>);
+    if (count == 0) return {};
+    if constexpr (not BulkSerialisable<T>) {
+        return PackedStruct<T>::Read(r, out, count);
+    } else if constexpr (IsVarint<T>(r.encoding())) {
+        return ReadVarints(r, out, count);
+    } else {
+        Try(r.read_bytes_into(out, count * sizeof(T)));
+        if constexpr (sizeof(T) > 1 and r.endianness() != std::endian::native) ByteSwap(out, count, sizeof(T));
+        return {};
+    }
+}
+
+/// Write 'count' values from 'in'.
+template <typename T>
+void WriteBulk(auto& w, const T* in, usz count) {
+    static_assert(BulkCopyable<T, w.encoding()>);
+    if (count == 0) return;
+    if constexpr (not BulkSerialisable<T>) {
+        PackedStruct<T>::Write(w, in, count);
+    } else if constexpr (IsVarint<T>(w.encoding())) {
+        WriteVarints(w, in, count);
+    } else if constexpr (sizeof(T) > 1 and w.endianness() != std::endian::native) {
+        // Swap the values in chunks so we don’t need a copy of all of them
+        // at once if we’re writing to a sink.
+        constexpr usz ChunkElements = ser::DefaultChunkSize / sizeof(T);
+        for (usz i = 0; i < count; i += ChunkElements) {
+            auto n = std::min(count - i, ChunkElements);
+            auto bytes = w.allocate(n * sizeof(T));
+            std::memcpy(bytes.data(), in + i, n * sizeof(T));
+            ByteSwap(bytes.data(), n, sizeof(T));
+        }
+    } else {
+        w.append_bytes(in, count * sizeof(T));
+    }
+}
+
+/// Read a size followed by that many values, without copying them.
+///
+/// The returned span points into the reader’s buffer. Since the values
+/// aren’t copied, they can’t be byte-swapped or realigned either, so
+/// this fails if the data is not suitably aligned, and values larger
+/// than a byte can only be viewed if the serialised endianness is the
+/// native one.
+template <BulkSerialisable T>
+auto ReadView(auto& r) -> Result<std::span<const T>> {
+    static_assert(
+        sizeof(T) == 1 or r.endianness() == std::endian::native,
+        "Cannot create a view of data whose endianness isn’t the native one"
+    );
+
+    static_assert(not IsVarint<T>(r.encoding()), "Cannot create a view of varints");
+
+    // The buffer of a reader that reads from a source is reused.
+    if (r.has_source()) return Error("Cannot create a view of data that is read from a source");
+    auto size = Try(r.template read<u64>());
+    if (size > r.size() / sizeof(T)) [[unlikely]] {
+        return Error(
+            "Not enough data to read {} elements ({} bytes left)",
+            size,
+            r.size()
+        );
+    }
+
+    if (size == 0) return {};
+    auto bytes = Try(r.read_bytes(usz(size) * sizeof(T)));
+    if (reinterpret_cast<uptr>(bytes.data()) % alignof(T) != 0) [[unlikely]] {
+        return Error(
+            "Cannot create a view of data that is not aligned to {} bytes",
+            alignof(T)
+        );
+    }
+
+    return std::span{reinterpret_cast<const T*>(bytes.data()), usz(size)};
+}
+
+/// Write a size followed by that many values.
+template <BulkSerialisable T>
+void WriteView(auto& w, std::span<const T> values) {
+    w << u64(values.size());
+    WriteBulk(w, values.data(), values.size());
+}
+} // namespace base::detail
+
+/// ====================================================================
+///  Packed Structs
+/// ====================================================================
+namespace base::detail {
+/// Check whether the fields of an object are laid out in memory in
+/// the order in which they are passed to this, without padding.
+///
+/// This compares addresses and so can’t be done at compile time, but
+/// the offsets of the fields are constants, so the compiler can fold
+/// this to 'true' or 'false'.
+template <typename Class, typename... Fields>
+auto IsPackedLayout(const Class* self, const Fields&... fields) -> bool {
+    if constexpr (sizeof(Class) != (usz(0) + ... + sizeof(Fields))) {
+        return false;
+    } else {
+        auto base = reinterpret_cast<const std::byte*>(self);
+        usz offset = 0;
+        return (
+            (reinterpret_cast<const std::byte*>(std::addressof(fields)) == base + std::exchange(offset, offset + sizeof(Fields)))
+            and ...
+        );
+    }
+}
+
+/// Reverse the byte order of a value in place.
+template <typename T>
+void ByteSwapValue(std::byte* data) {
+    if constexpr (sizeof(T) == 2 or sizeof(T) == 4 or sizeof(T) == 8) {
+        using Int = std::conditional_t<sizeof(T) == 2, u16, std::conditional_t<sizeof(T) == 4, u32, u64>>;
+        Int val;
+        std::memcpy(&val, data, sizeof(Int));
+        val = std::byteswap(val);
+        std::memcpy(data, &val, sizeof(Int));
+    } else if constexpr (sizeof(T) > 1) {
+        ByteSwap(data, 1, sizeof(T));
+    }
+}
+
+/// Helper to copy types declared with LIBBASE_SERIALISE() as a whole.
+///
+/// A type is packed if its serialised form is its object representation,
+/// modulo byte order, i.e. if all of its fields are arithmetic types that
+/// are laid out in order and without padding, and if it has no other
+/// members. Objects of such types, and sequences thereof, are read and
+/// written with a single copy, followed by a byte swap of each field if
+/// the serialised endianness isn’t the native one.
+template <typename Class>
+struct PackedStruct {
+    /// Check whether the type could be packed; whether it is also depends
+    /// on the order of its fields, which is checked by IsPacked().
+    template <ser::Encoding Enc>
+    static consteval auto Packable() -> bool {
+        if constexpr (requires { Class::_libbase_serialised_fields(); }) {
+            return PackableFields<Enc>(decltype(Class::_libbase_serialised_fields()){});
+        } else {
+            return false;
+        }
+    }
+
+    /// Check whether the fields are laid out in the order in which they
+    /// are serialised.
+    ///
+    /// Only call this if Packable() is true.
+    static auto IsPacked() -> bool {
+        // Any object will do since we only look at the addresses of its fields.
+        auto c = std::bit_cast<Class>(std::array<std::byte, sizeof(Class)>{});
+        return c._libbase_packed_layout();
+    }
+
+    /// Read a single object.
+    static auto Read(auto& r) -> Result<Class> {
+        std::array<std::byte, sizeof(Class)> bytes;
+        Try(r.read_bytes_into(bytes.data(), sizeof(Class)));
+        if constexpr (r.endianness() != std::endian::native) Swap(bytes.data(), 1);
+        return std::bit_cast<Class>(bytes);
+    }
+
+    /// Read 'count' objects into 'out'.
+    static auto Read(auto& r, Class* out, usz count) -> Result<> {
+        if (not IsPacked()) {
+            for (usz i = 0; i < count; i++) out[i] = Try(r.template read<Class>());
+            return {};
+        }
+
+        Try(r.read_bytes_into(out, count * sizeof(Class)));
+        if constexpr (r.endianness() != std::endian::native) Swap(reinterpret_cast<std::byte*>(out), count);
+        return {};
+    }
+
+    /// Write 'count' objects from 'in'.
+    static void Write(auto& w, const Class* in, usz count) {
+        if (not IsPacked()) {
+            for (usz i = 0; i < count; i++) w << in[i];
+        } else if constexpr (w.endianness() != std::endian::native) {
+            constexpr usz ChunkElements = std::max<usz>(ser::DefaultChunkSize / sizeof(Class), 1);
+            for (usz i = 0; i < count; i += ChunkElements) {
+                auto n = std::min(count - i, ChunkElements);
+                auto bytes = w.allocate(n * sizeof(Class));
+                std::memcpy(bytes.data(), in + i, n * sizeof(Class));
+                Swap(bytes.data(), n);
+            }
+        } else {
+            w.append_bytes(in, count * sizeof(Class));
+        }
+    }
+
+private:
+    template <ser::Encoding Enc, typename... Fields>
+    static consteval auto PackableFields(std::type_identity<std::tuple<Fields...>>) -> bool {
+        return std::is_trivially_copyable_v<Class>
+           and sizeof(Class) == (usz(0) + ... + sizeof(Fields))
+           and ((BulkSerialisable<Fields> and not IsVarint<Fields>(Enc)) and ...)
+           and not requires { Class{ser::deserialise_tag{}, std::declval<Fields>()...}; };
+    }
+
+    /// Reverse the byte order of every field of 'count' objects.
+    static void Swap(std::byte* data, usz count) {
+        [&]<typename... Fields>(std::type_identity<std::tuple<Fields...>>) {
+            // If all fields have the same size, this is just an array of values.
+            constexpr usz FieldSize = sizeof(Class) / sizeof...(Fields);
+            if constexpr (((sizeof(Fields) == FieldSize) and ...)) {
+                if constexpr (FieldSize > 1) ByteSwap(data, count * sizeof...(Fields), FieldSize);
+            } else {
+                for (usz i = 0; i < count; i++, data += sizeof(Class)) {
+                    usz offset = 0;
+                    (ByteSwapValue<Fields>(data + std::exchange(offset, offset + sizeof(Fields))), ...);
+                }
+            }
+        }(Class::_libbase_serialised_fields());
+    }
+};
+} // namespace base::detail
+
+/// ====================================================================
+///  Serialised Size
+/// ====================================================================
+namespace base::detail {
+template <typename T, ser::Encoding Enc>
+struct FixedSerialisedSizeImpl {
+    static constexpr std::optional<usz> value = []() -> std::optional<usz> {
+        if constexpr (std::is_enum_v<T>) return FixedSerialisedSizeImpl<std::underlying_type_t<T>, Enc>::value;
+        else if constexpr (std::same_as<T, bool>) return 1;
+        else if constexpr (BulkSerialisable<T> and not IsVarint<T>(Enc)) return sizeof(T);
+        else if constexpr (PackedStruct<T>::template Packable<Enc>()) return sizeof(T);
+        else if constexpr (utils::is_same<T, std::monostate, std::nullptr_t>) return 0;
+        else return std::nullopt;
+    }();
+};
+
+template <typename T, usz N, ser::Encoding Enc>
+struct FixedSerialisedSizeImpl<std::array<T, N>, Enc> {
+    static constexpr std::optional<usz> value = FixedSerialisedSizeImpl<T, Enc>::value.transform(
+        [](usz size) { return size * N; }
+    );
+};
+
+template <typename... Ts, ser::Encoding Enc>
+struct FixedSerialisedSizeImpl<std::tuple<Ts...>, Enc> {
+    static constexpr std::optional<usz> value = (FixedSerialisedSizeImpl<Ts, Enc>::value.has_value() and ...)
+        ? std::optional<usz>{(usz(0) + ... + *FixedSerialisedSizeImpl<Ts, Enc>::value)}
+        : std::nullopt;
+};
+
+template <typename A, typename B, ser::Encoding Enc>
+struct FixedSerialisedSizeImpl<std::pair<A, B>, Enc> : FixedSerialisedSizeImpl<std::tuple<A, B>, Enc> {};
+} // namespace base::detail
+
+namespace base::ser {
+/// The number of bytes that every value of a type takes up when it
+/// is serialised, or std::nullopt if that depends on the value.
+template <typename T, Encoding SerialisedEncoding = Encoding::Fixed>
+constexpr std::optional<usz> FixedSerialisedSize = detail::FixedSerialisedSizeImpl<T, SerialisedEncoding>::value;
+}
+
+template <base::ser::Encoding SerialisedEncoding, std::endian SerialisedEndianness, typename T>
+auto base::ser::SerialisedSize(const T& t) -> usz {
+    if constexpr (constexpr auto size = FixedSerialisedSize<T, SerialisedEncoding>; size.has_value()) {
+        return *size;
+    } else {
+        Writer<SerialisedEndianness, SerialisedEncoding> w{count_only_tag{}};
+        w << t;
+        return w.written();
+    }
+}
+
+/// ====================================================================
+///  Indexed Ranges
+/// ====================================================================
+namespace base::detail {
+/// Offset table of a range that was serialised with 'ser::Indexed'.
+class OffsetTable {
+    ByteSpan offsets;
+    ByteSpan data;
+    bool swap = false;
+
+public:
+    OffsetTable() = default;
+
+    /// Read the number of elements and the offset table and take
+    /// the data of the elements.
+    static auto Read(auto& r) -> Result<OffsetTable> {
+        // The buffer of a reader that reads from a source is reused.
+        if (r.has_source()) return Error("Cannot create a view of data that is read from a source");
+        auto count = Try(r.template read<u64>());
+        if (count >= r.size() / sizeof(u64)) [[unlikely]] {
+            return Error(
+                "Not enough data to read {} offsets ({} bytes left)",
+                count + 1,
+                r.size()
+            );
+        }
+
+        OffsetTable t;
+        t.swap = r.endianness() != std::endian::native;
+        t.offsets = Try(r.read_bytes(usz(count + 1) * sizeof(u64)));
+        t.data = Try(r.read_bytes(usz(t.offset(usz(count)))));
+        return t;
+    }
+
+    /// Get the serialised data of an element.
+    [[nodiscard]] auto entry(usz i) const -> Result<ByteSpan>;
+
+    /// Get the number of elements.
+    [[nodiscard]] auto size() const -> usz {
+        return offsets.empty() ? 0 : offsets.size() / sizeof(u64) - 1;
+    }
+
+private:
+    [[nodiscard]] auto offset(usz i) const -> u64 {
+        u64 val;
+        std::memcpy(&val, offsets.data() + i * sizeof(u64), sizeof(u64));
+        return swap ? std::byteswap(val) : val;
+    }
+};
+} // namespace base::detail
+
+/// Wrapper to serialise a range with an offset table.
+///
+/// The serialised form is the number of elements, followed by the offset
+/// of the start of each element and of the end of the last one, which are
+/// always 64-bit integers, even if the encoding is 'Varint', followed by
+/// the elements. Maps are sorted by key.
+///
+/// Deserialise this as an IndexedView or IndexedMapView to access single
+/// elements without reading the ones before them, e.g.
+///
+/// \code
+///     auto bytes = ser::Serialise<std::endian::little>(ser::Indexed{names});
+///     auto view = ser::Deserialise<ser::IndexedView<std::string_view>, std::endian::little>(bytes).value();
+///     auto last = view.at(view.size() - 1).value();
+/// \endcode
+template <typename Range>
+struct base::ser::Indexed {
+    const Range& range;
+};
+
+template <typename Range>
+base::ser::Indexed(const Range&) -> base::ser::Indexed<Range>;
+
+/// View of a range that was serialised with an offset table.
+///
+/// This only reads the offset table; elements are deserialised when
+/// they are accessed. The view points into the data it was deserialised
+/// from, so it can’t be read from a source.
+template <typename T>
+class base::ser::IndexedView {
+    template <typename> friend struct Serialiser;
+
+    detail::OffsetTable table;
+    Result<T> (*decode)(ByteSpan) = nullptr;
+
+public:
+    /// Create an empty view.
+    IndexedView() = default;
+
+    /// Deserialise the element at an index.
+    [[nodiscard]] auto at(usz i) const -> Result<T> { return decode(Try(table.entry(i))); }
+
+    /// Get the serialised data of the element at an index.
+    [[nodiscard]] auto bytes(usz i) const -> Result<ByteSpan> { return table.entry(i); }
+
+    /// Check if the view is empty.
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+    /// Get the number of elements.
+    [[nodiscard]] auto size() const -> usz { return table.size(); }
+};
+
+/// View of a map that was serialised with an offset table.
+///
+/// The entries are sorted by key, so keys can be looked up by binary
+/// search, which only deserialises the keys that are compared against
+/// and the value that is found.
+template <typename Key, typename Value>
+class base::ser::IndexedMapView {
+    template <typename> friend struct Serialiser;
+
+    detail::OffsetTable table;
+    Result<Key> (*decode_key)(ByteSpan) = nullptr;
+    Result<Value> (*decode_value)(ByteSpan) = nullptr;
+
+public:
+    /// Create an empty view.
+    IndexedMapView() = default;
+
+    /// Deserialise the entry at an index.
+    [[nodiscard]] auto at(usz i) const -> Result<std::pair<Key, Value>> {
+        auto entry = Try(table.entry(i));
+        return std::pair<Key, Value>{Try(decode_key(entry)), Try(decode_value(entry))};
+    }
+
+    /// Check if the map contains a key.
+    [[nodiscard]] auto contains(const auto& key) const -> Result<bool> {
+        return Try(find_entry(key)).has_value();
+    }
+
+    /// Check if the view is empty.
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+    /// Look up the value of a key.
+    [[nodiscard]] auto find(const auto& key) const -> Result<std::optional<Value>> {
+        auto entry = Try(find_entry(key));
+        if (not entry.has_value()) return std::nullopt;
+        return Try(decode_value(*entry));
+    }
+
+    /// Deserialise the key at an index.
+    [[nodiscard]] auto key(usz i) const -> Result<Key> { return decode_key(Try(table.entry(i))); }
+
+    /// Get the number of entries.
+    [[nodiscard]] auto size() const -> usz { return table.size(); }
+
+private:
+    auto find_entry(const auto& key) const -> Result<std::optional<ByteSpan>> {
+        usz lo = 0, hi = size();
+        while (lo < hi) {
+            auto mid = lo + (hi - lo) / 2;
+            auto entry = Try(table.entry(mid));
+            auto k = Try(decode_key(entry));
+            if (std::less<>{}(k, key)) lo = mid + 1;
+            else if (std::less<>{}(key, k)) hi = mid;
+            else return entry;
+        }
+
+        return std::nullopt;
+    }
+};
+
+/// Wrapper to serialise a range on several threads.
+///
+/// The range is split into chunks, each of which is serialised into a
+/// separate buffer on its own thread; the buffers are then written one
+/// after the other, preceded by the number of elements and the size of
+/// each chunk. Deserialising a 'Parallel<Vector>' deserialises the
+/// chunks on several threads as well, e.g.
+///
+/// \code
+///     auto bytes = ser::Serialise<std::endian::little>(ser::Parallel{state});
+///     auto restored = ser::Deserialise<ser::Parallel<std::vector<Entry>>, std::endian::little>(bytes).value().range;
+/// \endcode
+///
+/// Since the elements are serialised independently of one another, this
+/// is only worth it if they are expensive to serialise. The serialised
+/// data depends on the number of threads used to serialise it, but it
+/// can be deserialised using any number of threads.
+template <typename Range>
+struct base::ser::Parallel {
+    /// The range to serialise, or the range that was deserialised.
+    Range range;
+
+    /// How many threads to use to serialise the range; if 0, we use
+    /// one thread per hardware thread.
+    usz threads = 0;
+};
+
+template <typename Range>
+base::ser::Parallel(const Range&, base::usz = 0) -> base::ser::Parallel<const Range&>;
+
 /// ====================================================================
 ///  Built-in Serialisers
 /// ====================================================================
@@ -268,6 +1167,9 @@ void base::ser::Serialise(std::vector<std::byte>& into, const T& t) {
 template <std::integral Int>
 struct base::ser::Serialiser<Int> {
     static auto deserialise(auto& r) -> Result<Int> {
+        if constexpr (detail::IsVarint<Int>(r.encoding()))
+            return detail::FromVarint<Int>(Try(r.read_varint()));
+
         Int val{};
         Try(r.read_bytes_into(&val, sizeof(Int)));
         if constexpr (r.endianness() != std::endian::native) val = std::byteswap(val);
@@ -275,6 +1177,12 @@ struct base::ser::Serialiser<Int> {
     }
 
     static void serialise(auto& w, Int val) {
+        if constexpr (detail::IsVarint<Int>(w.encoding())) {
+            std::byte buf[detail::MaxVarintSize];
+            w.append_bytes(buf, detail::EncodeVarint(detail::ToVarint(val), buf));
+            return;
+        }
+
         if constexpr (w.endianness() != std::endian::native) val = std::byteswap(val);
         w.append_bytes(&val, sizeof(Int));
     }
@@ -300,27 +1208,26 @@ struct base::ser::Serialiser<bool> {
     }
 };
 
-/// Serialiser for 'float'.
-template <>
-struct base::ser::Serialiser<float> {
-    static auto deserialise(auto& r) -> Result<float> {
-        return std::bit_cast<float>(Try(r.template read<u32>()));
-    }
-
-    static void serialise(auto& w, float value) {
-        w << std::bit_cast<u32>(value);
-    }
-};
-
-/// Serialiser for 'double'.
-template <>
-struct base::ser::Serialiser<double> {
-    static auto deserialise(auto& r) -> Result<double> {
-        return std::bit_cast<double>(Try(r.template read<u64>()));
+/// Serialiser for 'float' and 'double'.
+///
+/// These are always stored as raw IEEE 754 values, even if integers
+/// are encoded as varints.
+template <typename Float>
+requires std::same_as<Float, float> or std::same_as<Float, double>
+struct base::ser::Serialiser<Float> {
+    using Bits = std::conditional_t<sizeof(Float) == sizeof(u32), u32, u64>;
+
+    static auto deserialise(auto& r) -> Result<Float> {
+        Bits bits{};
+        Try(r.read_bytes_into(&bits, sizeof(Bits)));
+        if constexpr (r.endianness() != std::endian::native) bits = std::byteswap(bits);
+        return std::bit_cast<Float>(bits);
     }
 
-    static void serialise(auto& w, double value) {
-        w << std::bit_cast<u64>(value);
+    static void serialise(auto& w, Float value) {
+        auto bits = std::bit_cast<Bits>(value);
+        if constexpr (w.endianness() != std::endian::native) bits = std::byteswap(bits);
+        w.append_bytes(&bits, sizeof(Bits));
     }
 };
 
@@ -357,38 +1264,80 @@ struct base::ser::Serialiser<std::basic_string<Char>> {
 
         Result<> read_result;
         str.resize_and_overwrite(usz(size), [&](Char* ptr, usz sz) {
-            read_result = r.read_bytes_into(ptr, sz * sizeof(Char));
+            read_result = detail::ReadBulk(r, ptr, sz);
             return sz;
         });
         Try(std::move(read_result));
-
-        if constexpr (r.endianness() != std::endian::native and sizeof(Char) != sizeof(char)) {
-            rgs::transform(
-                str.begin(),
-                str.end(),
-                str.begin(),
-                std::byteswap<Char>
-            );
-        }
-
         return str;
     }
 
     static void serialise(auto& w, const std::basic_string<Char>& str) {
         w << SizeType(str.size());
+        detail::WriteBulk(w, str.data(), str.size());
+    }
+};
 
-        usz size_bytes = usz(str.size()) * sizeof(Char);
-        if constexpr (w.endianness() != std::endian::native and sizeof(Char) != sizeof(char)) {
-            auto bytes = w.allocate(size_bytes);
-            rgs::transform(
-                str.begin(),
-                str.end(),
-                reinterpret_cast<Char*>(bytes.data()),
-                std::byteswap<Char>
-            );
-        } else {
-            w.append_bytes(str.data(), size_bytes);
-        }
+/// Serialiser for string views.
+///
+/// The serialised form is the same as that of 'std::basic_string', but
+/// deserialising a view doesn’t copy anything: the view points into the
+/// buffer of the reader and is only valid for as long as that buffer is.
+///
+/// \see detail::ReadView()
+template <base::utils::is_same<char, char8_t, char16_t, char32_t> Char>
+struct base::ser::Serialiser<std::basic_string_view<Char>> {
+    static auto deserialise(auto& r) -> Result<std::basic_string_view<Char>> {
+        auto s = Try(detail::ReadView<Char>(r));
+        return std::basic_string_view<Char>{s.data(), s.size()};
+    }
+
+    static void serialise(auto& w, std::basic_string_view<Char> str) {
+        detail::WriteView(w, std::span{str.data(), str.size()});
+    }
+};
+
+/// Serialiser for 'base::basic_str'.
+///
+/// \see Serialiser<std::basic_string_view>
+template <base::utils::is_same<char, char8_t, char16_t, char32_t> Char>
+struct base::ser::Serialiser<base::basic_str<Char>> {
+    static auto deserialise(auto& r) -> Result<basic_str<Char>> {
+        return basic_str<Char>{Try(r.template read<std::basic_string_view<Char>>())};
+    }
+
+    static void serialise(auto& w, basic_str<Char> str) {
+        w << str.text();
+    }
+};
+
+/// Serialiser for byte spans.
+///
+/// \see Serialiser<std::basic_string_view>
+template <>
+struct base::ser::Serialiser<base::ByteSpan> {
+    static auto deserialise(auto& r) -> Result<ByteSpan> {
+        auto s = Try(detail::ReadView<u8>(r));
+        return ByteSpan{s.data(), s.size()};
+    }
+
+    static void serialise(auto& w, ByteSpan bytes) {
+        detail::WriteView(w, std::span{reinterpret_cast<const u8*>(bytes.data()), bytes.size()});
+    }
+};
+
+/// Serialiser for spans of arithmetic types.
+///
+/// The serialised form is the same as that of 'std::vector<T>'.
+///
+/// \see Serialiser<std::basic_string_view>
+template <base::detail::BulkSerialisable T>
+struct base::ser::Serialiser<base::Span<T>> {
+    static auto deserialise(auto& r) -> Result<Span<T>> {
+        return Span<T>{Try(detail::ReadView<T>(r))};
+    }
+
+    static void serialise(auto& w, Span<T> values) {
+        detail::WriteView<T>(w, values);
     }
 };
 
@@ -410,6 +1359,16 @@ struct base::ser::Serialiser<Vector> {
     using SizeType = u64; // Not 'size_t' because that’s platform-dependent.
     using Element = Vector::value_type;
 
+    /// Whether we can copy the elements directly.
+    ///
+    /// 'resize()' is usually unconstrained, so check that the elements
+    /// are default-constructible ourselves.
+    template <Encoding Enc>
+    static constexpr bool Bulk = detail::BulkCopyable<Element, Enc> and
+                                 std::default_initializable<Element> and
+                                 rgs::contiguous_range<Vector> and
+                                 requires (Vector& v) { v.resize(usz()); };
+
     static auto deserialise(auto& r) -> Result<Vector> {
         Vector vec;
         auto size = Try(r.template read<SizeType>());
@@ -421,18 +1380,48 @@ struct base::ser::Serialiser<Vector> {
             );
         }
 
-        if constexpr (requires { vec.reserve(size); })
-            vec.reserve(size);
+        // Read arithmetic types and packed structs in one go if we can.
+        if constexpr (Bulk<r.encoding()>) {
+            // If we’re reading from a source, we don’t know how much data
+            // there is, so read it in chunks to avoid allocating a huge
+            // vector if the size is wrong.
+            if (r.has_source()) {
+                constexpr usz ChunkElements = DefaultChunkSize / sizeof(Element);
+                for (usz i = 0; i < size; i += ChunkElements) {
+                    auto n = std::min(usz(size) - i, ChunkElements);
+                    vec.resize(i + n);
+                    Try(detail::ReadBulk(r, vec.data() + i, n));
+                }
+
+                return vec;
+            }
+
+            constexpr usz MinElementSize = detail::IsVarint<Element>(r.encoding()) ? 1 : sizeof(Element);
+            if (size > r.size() / MinElementSize) [[unlikely]] {
+                return Error(
+                    "Not enough data to read {} elements ({} bytes left)",
+                    size,
+                    r.size()
+                );
+            }
 
-        for (SizeType i = 0; i < size; ++i)
-            vec.push_back(Try(r.template read<Element>()));
+            vec.resize(usz(size));
+            Try(detail::ReadBulk(r, vec.data(), vec.size()));
+        } else {
+            if constexpr (requires { vec.reserve(size); })
+                vec.reserve(size);
+
+            for (SizeType i = 0; i < size; ++i)
+                vec.push_back(Try(r.template read<Element>()));
+        }
 
         return vec;
     }
 
     static void serialise(auto& w, const Vector& v) {
         w << SizeType(v.size());
-        for (const Element& val : v) w << val;
+        if constexpr (Bulk<w.encoding()>) detail::WriteBulk(w, v.data(), v.size());
+        else for (const Element& val : v) w << val;
     }
 };
 
@@ -441,13 +1430,18 @@ template <typename Element, std::size_t N>
 struct base::ser::Serialiser<std::array<Element, N>> {
     static auto deserialise(auto& r) -> Result<std::array<Element, N>> {
         std::array<Element, N> array;
-        for (usz i = 0; i < N; ++i)
-            array[i] = Try(r.template read<Element>());
+        if constexpr (detail::BulkCopyable<Element, r.encoding()>) {
+            Try(detail::ReadBulk(r, array.data(), N));
+        } else {
+            for (usz i = 0; i < N; ++i)
+                array[i] = Try(r.template read<Element>());
+        }
         return array;
     }
 
     static void serialise(auto& w, const std::array<Element, N>& array) {
-        for (const Element& val : array) w << val;
+        if constexpr (detail::BulkCopyable<Element, w.encoding()>) detail::WriteBulk(w, array.data(), N);
+        else for (const Element& val : array) w << val;
     }
 };
 
@@ -619,6 +1613,218 @@ struct base::ser::Serialiser<Map> {
     }
 };
 
+/// Serialiser for ranges with an offset table.
+template <typename Range>
+struct base::ser::Serialiser<base::ser::Indexed<Range>> {
+    static constexpr bool IsMap = requires { typename Range::key_type; typename Range::mapped_type; };
+
+    static void serialise(auto& w, const Indexed<Range>& indexed) {
+        using W = std::remove_cvref_t<decltype(w)>;
+        std::vector<const rgs::range_value_t<Range>*> elements;
+        if constexpr (rgs::sized_range<Range>) elements.reserve(rgs::size(indexed.range));
+        for (const auto& e : indexed.range) elements.push_back(std::addressof(e));
+
+        // Maps need to be sorted for lookups, but not every map
+        // iterates over its entries in ascending order.
+        if constexpr (IsMap) {
+            auto Key = [](const auto* e) -> const auto& { return e->first; };
+            if (not rgs::is_sorted(elements, std::less<>{}, Key))
+                rgs::sort(elements, std::less<>{}, Key);
+        }
+
+        std::vector<u64> offsets;
+        offsets.reserve(elements.size() + 1);
+        offsets.push_back(0);
+        for (const auto* e : elements) {
+            auto size = [&] {
+                if constexpr (IsMap) {
+                    return SerialisedSize<W::encoding(), W::endianness()>(e->first)
+                         + SerialisedSize<W::encoding(), W::endianness()>(e->second);
+                } else {
+                    return SerialisedSize<W::encoding(), W::endianness()>(*e);
+                }
+            }();
+
+            offsets.push_back(offsets.back() + size);
+        }
+
+        w << u64(elements.size());
+        if constexpr (W::endianness() != std::endian::native) detail::ByteSwap(offsets.data(), offsets.size(), sizeof(u64));
+        w.append_bytes(offsets.data(), offsets.size() * sizeof(u64));
+        for (const auto* e : elements) {
+            if constexpr (IsMap) w << e->first << e->second;
+            else w << *e;
+        }
+    }
+};
+
+/// Serialiser for views of ranges with an offset table.
+template <typename T>
+struct base::ser::Serialiser<base::ser::IndexedView<T>> {
+    static auto deserialise(auto& r) -> Result<IndexedView<T>> {
+        using R = std::remove_cvref_t<decltype(r)>;
+        IndexedView<T> view;
+        view.table = Try(detail::OffsetTable::Read(r));
+        view.decode = [](ByteSpan bytes) { return Deserialise<T, R::endianness(), R::encoding()>(bytes); };
+        return view;
+    }
+};
+
+/// Serialiser for views of maps with an offset table.
+template <typename Key, typename Value>
+struct base::ser::Serialiser<base::ser::IndexedMapView<Key, Value>> {
+    static auto deserialise(auto& r) -> Result<IndexedMapView<Key, Value>> {
+        using R = std::remove_cvref_t<decltype(r)>;
+        IndexedMapView<Key, Value> view;
+        view.table = Try(detail::OffsetTable::Read(r));
+        view.decode_key = [](ByteSpan bytes) { return Deserialise<Key, R::endianness(), R::encoding()>(bytes); };
+        view.decode_value = [](ByteSpan bytes) -> Result<Value> {
+            Reader<R::endianness(), R::encoding()> entry{bytes};
+            Try(entry.template read<Key>());
+            return entry.template read<Value>();
+        };
+        return view;
+    }
+};
+
+/// Serialiser for ranges that are serialised on several threads.
+template <typename Range>
+struct base::ser::Serialiser<base::ser::Parallel<Range>> {
+    using Vector = std::remove_cvref_t<Range>;
+    using Element = rgs::range_value_t<Vector>;
+
+    /// Don’t bother starting a thread for fewer elements than this.
+    static constexpr usz MinChunkSize = 1024;
+
+    static auto deserialise(auto& r) -> Result<Parallel<Range>> {
+        static_assert(not std::is_reference_v<Range>, "Deserialise a Parallel<Vector> instead");
+        using R = std::remove_cvref_t<decltype(r)>;
+
+        auto size = Try(r.template read<u64>());
+        auto chunk_count = Try(r.template read<u64>());
+        if (chunk_count > std::max<u64>(size, 1)) [[unlikely]] {
+            return Error(
+                "Invalid number of chunks {} for {} elements",
+                chunk_count,
+                size
+            );
+        }
+
+        // Read the number of elements and bytes in each chunk.
+        std::vector<std::pair<u64, u64>> chunks;
+        u64 elements = 0, total = 0;
+        for (u64 i = 0; i < chunk_count; i++) {
+            auto count = Try(r.template read<u64>());
+            auto bytes = Try(r.template read<u64>());
+            if (count > size - elements or bytes > std::numeric_limits<u64>::max() - total) [[unlikely]]
+                return Error("Invalid size for chunk {}", i);
+            chunks.emplace_back(count, bytes);
+            elements += count;
+            total += bytes;
+        }
+
+        if (elements != size) [[unlikely]] {
+            return Error(
+                "Chunks contain {} elements, but expected {}",
+                elements,
+                size
+            );
+        }
+
+        // Deserialise the chunks in parallel.
+        auto data = Try(r.read_bytes(usz(total)));
+        std::vector<Result<Vector>> parts(chunks.size());
+        std::vector<usz> offsets;
+        for (usz offset = 0; const auto& c : chunks) offsets.push_back(std::exchange(offset, offset + usz(c.second)));
+        auto Work = [&](usz chunk) -> Result<Vector> {
+            Reader<R::endianness(), R::encoding()> cr{data.subspan(offsets[chunk], usz(chunks[chunk].second))};
+            Vector part;
+            if constexpr (requires { part.reserve(usz()); }) part.reserve(usz(chunks[chunk].first));
+            for (u64 i = 0; i < chunks[chunk].first; i++) part.push_back(Try(cr.template read<Element>()));
+            if (cr.size() != 0) [[unlikely]] {
+                return Error(
+                    "Chunk {} contains {} bytes of trailing data",
+                    chunk,
+                    cr.size()
+                );
+            }
+            return part;
+        };
+
+        auto threads = std::min<usz>(std::max(1u, std::thread::hardware_concurrency()), chunks.size());
+        if (threads <= 1) {
+            for (usz i = 0; i < chunks.size(); i++) parts[i] = Work(i);
+        } else {
+            std::vector<std::jthread> workers;
+            workers.reserve(threads);
+            for (usz t = 0; t < threads; t++) {
+                workers.emplace_back([&, t] {
+                    for (usz i = t; i < chunks.size(); i += threads) parts[i] = Work(i);
+                });
+            }
+        }
+
+        Parallel<Range> p;
+        if constexpr (requires { p.range.reserve(usz()); }) p.range.reserve(usz(size));
+        for (auto& part : parts) {
+            auto elems = Try(std::move(part));
+            for (auto& e : elems) p.range.push_back(std::move(e));
+        }
+
+        return p;
+    }
+
+    static void serialise(auto& w, const Parallel<Range>& p) {
+        static_assert(
+            rgs::random_access_range<Vector> and rgs::sized_range<Vector>,
+            "Only random-access ranges can be serialised in parallel"
+        );
+
+        using W = std::remove_cvref_t<decltype(w)>;
+        const Vector& range = p.range;
+        auto size = usz(rgs::size(range));
+        auto threads = p.threads == 0 ? usz(std::max(1u, std::thread::hardware_concurrency())) : p.threads;
+        threads = std::max<usz>(std::min(threads, size / MinChunkSize), 1);
+
+        // Serialise each chunk into a separate buffer; if we’re only
+        // counting bytes, there is no need to store the data.
+        std::vector<std::vector<std::byte>> buffers(threads);
+        std::vector<usz> sizes(threads);
+        const usz chunk_size = size / threads;
+        auto Work = [&](usz i) {
+            auto start = i * chunk_size;
+            auto end = i == threads - 1 ? size : start + chunk_size;
+            auto Write = [&](auto&& cw) {
+                for (usz j = start; j < end; j++) cw << rgs::begin(range)[isz(j)];
+                sizes[i] = cw.written();
+            };
+
+            if (w.counting()) Write(Writer<W::endianness(), W::encoding()>{count_only_tag{}});
+            else Write(Writer<W::endianness(), W::encoding()>{buffers[i]});
+        };
+
+        if (threads == 1) {
+            Work(0);
+        } else {
+            std::vector<std::jthread> workers;
+            workers.reserve(threads);
+            for (usz i = 0; i < threads; i++) workers.emplace_back(Work, i);
+        }
+
+        w << u64(size) << u64(threads);
+        for (usz i = 0; i < threads; i++) {
+            auto end = i == threads - 1 ? size : (i + 1) * chunk_size;
+            w << u64(end - i * chunk_size) << u64(sizes[i]);
+        }
+
+        // Large buffers are passed on to a sink as they are.
+        for (usz i = 0; i < threads; i++) {
+            if (w.counting()) w.append_bytes(nullptr, sizes[i]);
+            else w.append_bytes(buffers[i].data(), buffers[i].size());
+        }
+    }
+};
+
 /// Serialiser for magic numbers.
 /*template <base::usz n>
 template <std::endian E>
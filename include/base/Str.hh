@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <base/Assert.hh>
+#include <base/CharSet.hh>
 #include <base/Regex.hh>
+#include <base/Searcher.hh>
 #include <base/Span.hh>
 #include <base/Text.hh>
 #include <base/TrieMap.hh>
@@ -36,6 +38,11 @@
 }()
 
 namespace base {
+namespace detail {
+template <typename CharType, typename Finder>
+class StrSplitView;
+}
+
 /// 'std::string_view' replacement.
 ///
 /// This is basically a 'std::basic_string_view', except that it has a number
@@ -56,6 +63,7 @@ public:
     using string_type = std::basic_string<char_type>;
     using iterator = text_type::iterator;
     using reverse_iterator = text_type::reverse_iterator;
+    using searcher = basic_searcher<char_type>;
 
 private:
     text_type _m_text;
@@ -227,6 +235,12 @@ public:
         return pos != text_type::npos;
     }
 
+    /// Check if the text contains a string.
+    [[nodiscard]] constexpr auto
+    contains(const searcher& s) const noexcept -> bool {
+        return s.find(_m_text) != text_type::npos;
+    }
+
     /// Check if the string contains any of a set of characters.
     [[nodiscard]] constexpr auto
     contains_any(basic_str chars) const noexcept -> bool {
@@ -234,6 +248,12 @@ public:
         return pos != text_type::npos;
     }
 
+    /// Check if the string contains any of a set of characters.
+    [[nodiscard]] constexpr auto
+    contains_any(const CharSet& chars) const noexcept -> bool {
+        return chars.find_first(_m_text) != size();
+    }
+
     /// Count the number of occurrences of a character.
     [[nodiscard]] constexpr auto
     count(char_type c) const noexcept -> size_type {
@@ -252,12 +272,39 @@ public:
         return count;
     }
 
+    /// Count the number of occurrences of a substring.
+    ///
+    /// An empty needle is never counted.
+    [[nodiscard]] constexpr auto
+    count(const searcher& s) const noexcept -> size_type {
+        if (s.size() == 0) return 0;
+        size_type count = 0;
+        for (
+            size_type pos = 0;
+            (pos = s.find(_m_text, pos)) != text_type::npos;
+            pos += s.size()
+        ) ++count;
+        return count;
+    }
+
     /// Count the number of any of a set of characters.
     [[nodiscard]] constexpr auto
     count_any(basic_str chars) const noexcept -> size_type {
-        return size_type(std::ranges::count_if(_m_text, [chars](char_type c) {
-            return chars.contains(c);
-        }));
+        if constexpr (sizeof(char_type) == 1) {
+            CharSet set;
+            for (auto c : chars) set.add(c);
+            return set.count(_m_text);
+        } else {
+            return size_type(std::ranges::count_if(_m_text, [chars](char_type c) {
+                return chars.contains(c);
+            }));
+        }
+    }
+
+    /// Count the number of any of a set of characters.
+    [[nodiscard]] constexpr auto
+    count_any(const CharSet& chars) const noexcept -> size_type {
+        return chars.count(_m_text);
     }
 
     /// \return The data pointer.
@@ -395,6 +442,13 @@ public:
         (void) take_back_while_any(chars);
         return *this;
     }
+
+    /// \see take_back_until(char_type)
+    constexpr auto
+    drop_back_while_any(const CharSet& chars) noexcept -> basic_str& {
+        (void) take_back_while_any(chars);
+        return *this;
+    }
     ///@}
 
     ///@{
@@ -420,6 +474,13 @@ public:
         return *this;
     }
 
+    /// \see take_until(char_type)
+    constexpr auto
+    drop_until(const CharSet& chars) noexcept -> basic_str& {
+        (void) take_until(chars);
+        return *this;
+    }
+
     /// \see take_until(char_type) const
     template <typename UnaryPredicate>
     requires requires (UnaryPredicate c) { c(char_type{}); }
@@ -436,6 +497,13 @@ public:
         return *this;
     }
 
+    /// \see take_until(char_type)
+    constexpr auto
+    drop_until_any(const CharSet& chars) noexcept -> basic_str& {
+        (void) take_until_any(chars);
+        return *this;
+    }
+
     constexpr auto
     drop_until_any(utils::ConvertibleRange<basic_str> auto&& strings) noexcept -> basic_str {
         (void) take_until_any(LIBBASE_FWD(strings));
@@ -449,6 +517,13 @@ public:
         return *this;
     }
 
+    /// \see take_until(char_type)
+    constexpr auto
+    drop_until_any_or_empty(const CharSet& chars) noexcept -> basic_str& {
+        (void) take_until_any_or_empty(chars);
+        return *this;
+    }
+
     constexpr auto
     drop_until_any_or_empty(utils::ConvertibleRange<basic_str> auto&& strings) noexcept -> basic_str {
         (void) take_until_any_or_empty(LIBBASE_FWD(strings));
@@ -501,12 +576,26 @@ public:
         return *this;
     }
 
+    /// \see take_until(char_type)
+    constexpr auto
+    drop_while(const CharSet& chars) noexcept -> basic_str& {
+        (void) take_while(chars);
+        return *this;
+    }
+
     /// \see take_until(char_type)
     constexpr auto
     drop_while_any(basic_str chars) noexcept -> basic_str& {
         (void) take_while_any(chars);
         return *this;
     }
+
+    /// \see take_until(char_type)
+    constexpr auto
+    drop_while_any(const CharSet& chars) noexcept -> basic_str& {
+        (void) take_while_any(chars);
+        return *this;
+    }
     ///@}
 
     /// Check if this string is empty.
@@ -618,6 +707,14 @@ public:
         return pos;
     }
 
+    /// Find the first occurrence of a string in this string.
+    [[nodiscard]] constexpr auto
+    first(const searcher& s) const noexcept -> std::optional<size_type> {
+        auto pos = s.find(_m_text);
+        if (pos == text_type::npos) return std::nullopt;
+        return pos;
+    }
+
     /// Find the first occurrence of a character in this string that
     /// satisfies a predicate.
     template <typename UnaryPredicate>
@@ -637,6 +734,14 @@ public:
         return pos;
     }
 
+    /// Find the first occurrence of any of a set of characters.
+    [[nodiscard]] constexpr auto
+    first_any(const CharSet& chars) const noexcept -> std::optional<size_type> {
+        auto pos = chars.find_first(_m_text);
+        if (pos == size()) return std::nullopt;
+        return pos;
+    }
+
     ///@{
     /// Delete all occurrences of consecutive characters, replacing them
     /// with another string.
@@ -720,6 +825,8 @@ public:
     /// separators are not included. The string is not modified.
     ///
     /// This always splits on '\n', irrespective of platform.
+    ///
+    /// \see LineIndex for random access to the lines of large texts.
     [[nodiscard]] constexpr auto lines() const noexcept {
         return split(LIBBASE_STR_LIT("\n"));
     }
@@ -728,6 +835,26 @@ public:
     /// the match and drop that many characters from the start of the stream.
     template <typename ValueType>
     auto match_prefix(const BasicTrieMap<char_type, ValueType>& trie) -> std::optional<ValueType> {
+        auto [depth, value] = trie.match_prefix_ptr(text());
+        if (not value) return std::nullopt;
+        drop(depth);
+        return *value;
+    }
+
+    /// Same as match_prefix(), but return a pointer to the value in the trie
+    /// instead of copying it; returns null if there is no match.
+    template <typename ValueType>
+    auto match_prefix_ptr(const BasicTrieMap<char_type, ValueType>& trie) -> const ValueType* {
+        auto [depth, value] = trie.match_prefix_ptr(text());
+        if (value) drop(depth);
+        return value;
+    }
+
+    /// Match the start of the stream against a static trie.
+    ///
+    /// \see match_prefix(const BasicTrieMap<char_type, ValueType>&)
+    template <typename ValueType, usz NodeCount>
+    constexpr auto match_prefix(const BasicStaticTrieMap<char_type, ValueType, NodeCount>& trie) -> std::optional<ValueType> {
         auto match = trie.match_prefix(text());
         if (not match.has_value()) return std::nullopt;
         drop(match->first);
@@ -806,9 +933,10 @@ public:
     /// return the resulting string.
     ///
     /// \see base::trie for replacing multiple strings at once.
+    template <typename Buffer = string_type>
     [[nodiscard]] constexpr auto
-    replace(basic_str from, basic_str to) const -> string_type {
-        string_type str;
+    replace(basic_str from, basic_str to) const -> Buffer {
+        Buffer str;
         usz pos = 0;
         for (;;) {
             auto next = _m_text.find(from._m_text, pos);
@@ -825,21 +953,49 @@ public:
     }
 
     /// \see replace(basic_str from, basic_str to) const
+    template <typename Buffer = string_type>
     [[nodiscard]] constexpr auto
-    replace(char_type from, basic_str to) const -> string_type {
-        return replace(basic_str{&from, 1}, to);
+    replace(const searcher& from, basic_str to) const -> Buffer {
+        Buffer str;
+        if (from.size() == 0) {
+            str += _m_text;
+            return str;
+        }
+
+        usz pos = 0;
+        for (;;) {
+            auto next = from.find(_m_text, pos);
+            if (next == text_type::npos) {
+                str += _m_text.substr(pos);
+                break;
+            }
+
+            str += _m_text.substr(pos, next - pos);
+            str += to;
+            pos = next + from.size();
+        }
+        return str;
     }
 
     /// \see replace(basic_str from, basic_str to) const
+    template <typename Buffer = string_type>
     [[nodiscard]] constexpr auto
-    replace(basic_str from, char_type to) const -> string_type {
-        return replace(from, basic_str{&to, 1});
+    replace(char_type from, basic_str to) const -> Buffer {
+        return replace<Buffer>(basic_str{&from, 1}, to);
     }
 
     /// \see replace(basic_str from, basic_str to) const
+    template <typename Buffer = string_type>
     [[nodiscard]] constexpr auto
-    replace(char_type from, char_type to) const -> string_type {
-        return replace(basic_str{&from, 1}, basic_str{&to, 1});
+    replace(basic_str from, char_type to) const -> Buffer {
+        return replace<Buffer>(from, basic_str{&to, 1});
+    }
+
+    /// \see replace(basic_str from, basic_str to) const
+    template <typename Buffer = string_type>
+    [[nodiscard]] constexpr auto
+    replace(char_type from, char_type to) const -> Buffer {
+        return replace<Buffer>(basic_str{&from, 1}, basic_str{&to, 1});
     }
 
     /// Match and replace individual characters.
@@ -860,9 +1016,10 @@ public:
     ///
     /// \see base::trie for replacing multiple (multi-character) strings
     /// in one pass.
+    template <typename Buffer = string_type>
     [[nodiscard]] constexpr auto
-    replace_many(basic_str from, basic_str to) const -> string_type {
-        string_type out;
+    replace_many(basic_str from, basic_str to) const -> Buffer {
+        Buffer out;
         basic_str s{*this};
         for (;;) {
             out += s.take_until_any(from);
@@ -917,11 +1074,20 @@ public:
     }
 
     /// Split the string into parts.
+    ///
+    /// The delimiter must outlive the range returned by this.
     [[nodiscard]] constexpr auto
     split(basic_str delimiter) const noexcept {
-        return _m_text
-            | vws::split(delimiter.text())
-            | vws::transform([](auto r) { return basic_str(text_type(r)); });
+        return split(searcher{delimiter.text()});
+    }
+
+    /// Split the string into parts.
+    ///
+    /// The searcher is copied into the range, but the needle it refers
+    /// to must outlive it.
+    [[nodiscard]] constexpr auto
+    split(const searcher& delimiter) const noexcept {
+        return detail::StrSplitView<char_type, searcher>{_m_text, delimiter};
     }
 
     ///@{
@@ -1124,6 +1290,14 @@ public:
         if (pos == text_type::npos) return std::exchange(_m_text, text_type());
         return take_back(size() - pos - 1);
     }
+
+    /// \see take_back_until(char_type)
+    [[nodiscard]] constexpr auto
+    take_back_while_any(const CharSet& chars) noexcept -> basic_str {
+        auto pos = chars.find_last_not(_m_text);
+        if (pos == text_type::npos) return std::exchange(_m_text, text_type());
+        return take_back(size() - pos - 1);
+    }
     ///@}
 
     ///@{
@@ -1234,12 +1408,24 @@ public:
         return res;
     }
 
+    /// \see take_until(char_type)
+    [[nodiscard]] constexpr auto
+    take_until(const CharSet& chars) noexcept -> basic_str {
+        return take_until_any(chars);
+    }
+
     /// \see take_until(char_type)
     [[nodiscard]] constexpr auto
     take_until_any(basic_str chars) noexcept -> basic_str {
         return _m_advance(std::min(_m_text.find_first_of(chars._m_text), size()));
     }
 
+    /// \see take_until(char_type)
+    [[nodiscard]] constexpr auto
+    take_until_any(const CharSet& chars) noexcept -> basic_str {
+        return _m_advance(chars.find_first(_m_text));
+    }
+
     /// \see take_until(char_type)
     [[nodiscard]] constexpr auto
     take_until_any(utils::ConvertibleRange<basic_str> auto&& strings) noexcept -> basic_str {
@@ -1257,6 +1443,14 @@ public:
         return _m_advance(pos);
     }
 
+    /// \see take_until(char_type)
+    [[nodiscard]] constexpr auto
+    take_until_any_or_empty(const CharSet& chars) noexcept -> basic_str {
+        auto pos = chars.find_first(_m_text);
+        if (pos == size()) return {};
+        return _m_advance(pos);
+    }
+
     /// \see take_until(char_type)
     [[nodiscard]] constexpr auto
     take_until_any_or_empty(utils::ConvertibleRange<basic_str> auto&& strings) noexcept -> basic_str {
@@ -1320,11 +1514,23 @@ public:
         return _m_take_while_cond(std::move(c));
     }
 
+    /// \see take_until(char_type)
+    [[nodiscard]] constexpr auto
+    take_while(const CharSet& chars) noexcept -> basic_str {
+        return take_while_any(chars);
+    }
+
     /// \see take_until(char_type)
     [[nodiscard]] constexpr auto
     take_while_any(basic_str chars) noexcept -> basic_str {
         return _m_take_while_any(chars);
     }
+
+    /// \see take_until(char_type)
+    [[nodiscard]] constexpr auto
+    take_while_any(const CharSet& chars) noexcept -> basic_str {
+        return _m_advance(chars.find_first_not(_m_text));
+    }
     ///@}
 
     /// Get the underlying string view for this string.
@@ -1344,6 +1550,12 @@ public:
         return trim_front(chars).trim_back(chars);
     }
 
+    /// \see trim(basic_str)
+    constexpr auto
+    trim(const CharSet& chars) noexcept -> basic_str& {
+        return trim_front(chars).trim_back(chars);
+    }
+
     /// \see trim(basic_str)
     constexpr auto
     trim_front(basic_str chars = whitespace()) noexcept -> basic_str& {
@@ -1362,6 +1574,20 @@ public:
         return *this;
     }
 
+    /// \see trim(basic_str)
+    constexpr auto
+    trim_front(const CharSet& chars) noexcept -> basic_str& {
+        _m_text.remove_prefix(chars.find_first_not(_m_text));
+        return *this;
+    }
+
+    /// \see trim(basic_str)
+    constexpr auto
+    trim_back(const CharSet& chars) noexcept -> basic_str& {
+        (void) take_back_while_any(chars);
+        return *this;
+    }
+
     ///@}
 
     /// Trim leading indentation.
@@ -1527,6 +1753,99 @@ using str8 = basic_str<char8_t>;
 using str16 = basic_str<char16_t>;
 using str32 = basic_str<char32_t>;
 
+/// Range returned by str::split().
+///
+/// This yields the same parts as 'std::views::split', i.e. there is an empty
+/// part after a trailing delimiter, an empty string has no parts, and an empty
+/// delimiter splits the string into individual characters.
+///
+/// 'Finder' is used to find the next delimiter and must provide the same
+/// 'find()' and 'size()' members as 'basic_searcher'.
+template <typename CharType, typename Finder>
+class detail::StrSplitView : public rgs::view_interface<detail::StrSplitView<CharType, Finder>> {
+    using text_type = std::basic_string_view<CharType>;
+
+    text_type text;
+    Finder finder;
+
+public:
+    class iterator {
+        friend StrSplitView;
+
+        const StrSplitView* view = nullptr;
+        usz start = 0;
+        usz stop = 0;
+        bool done = true;
+
+        constexpr iterator(const StrSplitView* view)
+            : view{view}, stop{view->next(0)}, done{false} {}
+
+    public:
+        using value_type = basic_str<CharType>;
+        using difference_type = isz;
+        using iterator_concept = std::forward_iterator_tag;
+
+        constexpr iterator() = default;
+
+        constexpr auto operator*() const -> value_type {
+            return value_type{view->text.substr(start, stop - start)};
+        }
+
+        constexpr auto operator++() -> iterator& {
+            if (stop == view->text.size()) {
+                done = true;
+            } else {
+                start = stop + view->finder.size();
+                stop = view->next(start);
+            }
+            return *this;
+        }
+
+        constexpr auto operator++(int) -> iterator {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+
+        constexpr bool operator==(const iterator& other) const {
+            if (done or other.done) return done == other.done;
+            return start == other.start;
+        }
+    };
+
+    constexpr StrSplitView(text_type text, Finder finder)
+        : text{text}, finder{std::move(finder)} {}
+
+    [[nodiscard]] constexpr auto begin() const -> iterator {
+        if (text.empty()) return end();
+        return iterator{this};
+    }
+
+    [[nodiscard]] constexpr auto end() const -> iterator {
+        return iterator{};
+    }
+
+private:
+    /// Get the end of the part that starts at 'from'.
+    constexpr auto next(usz from) const -> usz {
+        if (finder.size() == 0) return std::min(from + 1, text.size());
+        auto pos = finder.find(text, from);
+        return pos == text_type::npos ? text.size() : pos;
+    }
+};
+
+/// Operator that creates a character set at compile time.
+///
+/// \code
+///     s.take_while_any("0123456789abcdefABCDEF"_cs);
+/// \endcode
+///
+/// \see CharSet::FromPredicate()
+template <utils::static_string s>
+consteval auto operator""_cs() -> CharSet {
+    return CharSet{s.sv()};
+}
+
 /// Operator that trims leading indentation and leading/trailing
 /// whitespace from a string.
 ///
@@ -1562,7 +1881,6 @@ struct std::formatter<base::str> : std::formatter<std::string_view> {
     }
 };
 
-#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
 template <typename CharType>
 struct std::formatter<base::basic_str<CharType>> : std::formatter<std::string_view> {
     template <typename FormatContext>
@@ -1570,15 +1888,6 @@ struct std::formatter<base::basic_str<CharType>> : std::formatter<std::string_vi
         return std::formatter<std::string_view>::format(base::text::ToUTF8(s), ctx);
     }
 };
-#else
-template <typename CharType>
-struct std::formatter<base::basic_str<CharType>> {
-    static_assert(
-        false,
-        "Formatting str types other than 'str' is only supported if LIBBASE_ENABLE_UNICODE_SUPPORT is enabled"
-    );
-};
-#endif
 
 template <typename CharType>
 struct std::hash<base::basic_str<CharType>> :
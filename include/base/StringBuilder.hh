@@ -0,0 +1,174 @@
+#ifndef LIBBASE_STRINGBUILDER_HH
+#define LIBBASE_STRINGBUILDER_HH
+
+#include <base/Result.hh>
+#include <base/Types.hh>
+#include <algorithm>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace base {
+template <typename CharType>
+class BasicStringBuilder;
+
+using StringBuilder = BasicStringBuilder<char>;
+using StringBuilder8 = BasicStringBuilder<char8_t>;
+using StringBuilder16 = BasicStringBuilder<char16_t>;
+using StringBuilder32 = BasicStringBuilder<char32_t>;
+
+namespace fs {
+class File;
+}
+}
+
+/// Append-only string buffer made up of separately allocated chunks.
+///
+/// Appending to a 'std::string' reallocates and copies everything that
+/// has been appended so far every time the string runs out of capacity;
+/// this instead allocates a new chunk and leaves existing data where it
+/// is. The final string is either copied out once using flatten(), or
+/// written to a file directly using write_to().
+///
+/// Functions that build strings, e.g. str::replace() or str::remove_all(),
+/// can be told to use this instead of a 'std::string', e.g.
+///
+/// \code
+///     auto out = s.replace<StringBuilder>("foo", "bar");
+/// \endcode
+template <typename CharType>
+class base::BasicStringBuilder {
+public:
+    using char_type = CharType;
+    using text_type = std::basic_string_view<char_type>;
+    using string_type = std::basic_string<char_type>;
+
+private:
+    /// Size of the first chunk we allocate.
+    static constexpr usz MinChunkSize = 4'096 / sizeof(char_type);
+
+    /// Chunks grow geometrically up to this size.
+    static constexpr usz MaxChunkSize = (1 << 20) / sizeof(char_type);
+
+    struct Chunk {
+        std::unique_ptr<char_type[]> data;
+        usz size;
+        usz capacity;
+    };
+
+    std::vector<Chunk> chunk_list;
+    usz total = 0;
+    usz next_chunk_size = MinChunkSize;
+
+public:
+    /// Create an empty builder.
+    BasicStringBuilder() = default;
+
+    /// Create an empty builder with room for at least 'size_hint' characters.
+    explicit BasicStringBuilder(usz size_hint) { reserve_hint(size_hint); }
+
+    /// Append a string.
+    auto append(text_type s) -> BasicStringBuilder& {
+        if (s.empty()) return *this;
+        if (not chunk_list.empty()) {
+            auto& c = chunk_list.back();
+            auto n = std::min(s.size(), c.capacity - c.size);
+            std::copy_n(s.data(), n, c.data.get() + c.size);
+            c.size += n;
+            total += n;
+            s.remove_prefix(n);
+            if (s.empty()) return *this;
+        }
+
+        // Put the rest into a single chunk.
+        auto& c = grow(s.size());
+        std::copy_n(s.data(), s.size(), c.data.get());
+        c.size = s.size();
+        total += s.size();
+        return *this;
+    }
+
+    /// Append a character.
+    auto append(char_type c) -> BasicStringBuilder& {
+        if (chunk_list.empty() or chunk_list.back().size == chunk_list.back().capacity) grow(1);
+        auto& chunk = chunk_list.back();
+        chunk.data[chunk.size++] = c;
+        total++;
+        return *this;
+    }
+
+    /// Append a character 'count' times.
+    auto append(usz count, char_type c) -> BasicStringBuilder& {
+        reserve_hint(count);
+        while (count--) append(c);
+        return *this;
+    }
+
+    /// Get the chunks that make up the string, in order.
+    [[nodiscard]] auto chunks() const {
+        return chunk_list | vws::transform([](const Chunk& c) { return text_type{c.data.get(), c.size}; });
+    }
+
+    /// Delete the contents of the builder.
+    ///
+    /// This keeps the first chunk around to avoid having to reallocate it.
+    void clear() {
+        if (chunk_list.size() > 1) chunk_list.erase(chunk_list.begin() + 1, chunk_list.end());
+        if (not chunk_list.empty()) chunk_list.front().size = 0;
+        total = 0;
+    }
+
+    /// Check if the builder is empty.
+    [[nodiscard]] auto empty() const -> bool { return total == 0; }
+
+    /// Copy the contents of the builder into a string.
+    [[nodiscard]] auto flatten() const -> string_type {
+        string_type s;
+        flatten_into(s);
+        return s;
+    }
+
+    /// Append the contents of the builder to a string.
+    void flatten_into(string_type& s) const {
+        s.reserve(s.size() + total);
+        for (auto& c : chunk_list) s.append(c.data.get(), c.size);
+    }
+
+    /// Make sure that at least 'n' more characters can be appended without
+    /// allocating a new chunk.
+    ///
+    /// This is only a hint and may or may not allocate.
+    void reserve_hint(usz n) {
+        if (not chunk_list.empty() and chunk_list.back().capacity - chunk_list.back().size >= n) return;
+        grow(n);
+    }
+
+    /// Get the number of characters in the builder.
+    [[nodiscard]] auto size() const -> usz { return total; }
+
+    /// Write the contents of the builder to a file using scatter/gather I/O.
+    auto write_to(fs::File& file) const -> Result<>;
+
+    /// Append to the builder.
+    auto operator+=(text_type s) -> BasicStringBuilder& { return append(s); }
+    auto operator+=(char_type c) -> BasicStringBuilder& { return append(c); }
+
+private:
+    /// Allocate a new chunk with room for at least 'min_size' characters.
+    auto grow(usz min_size) -> Chunk& {
+        // An empty chunk at the end is too small for this, so drop it.
+        if (not chunk_list.empty() and chunk_list.back().size == 0) chunk_list.pop_back();
+        auto cap = std::max(min_size, next_chunk_size);
+        next_chunk_size = std::min(next_chunk_size * 2, MaxChunkSize);
+        return chunk_list.emplace_back(std::make_unique_for_overwrite<char_type[]>(cap), 0, cap);
+    }
+};
+
+extern template class base::BasicStringBuilder<char>;
+extern template class base::BasicStringBuilder<char8_t>;
+extern template class base::BasicStringBuilder<char16_t>;
+extern template class base::BasicStringBuilder<char32_t>;
+
+#endif // LIBBASE_STRINGBUILDER_HH
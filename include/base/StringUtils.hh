@@ -3,6 +3,7 @@
 
 #include <base/Utils.hh>
 #include <base/Str.hh>
+#include <base/StringBuilder.hh>
 
 namespace base::utils {
 /// Escape non-printable and formatting characters in a string.
@@ -12,6 +13,22 @@ auto Escape(
     bool escape_per_cent_signs = false
 ) -> std::string;
 
+/// Same as Escape(), but append the result to a string.
+void EscapeInto(
+    std::string& out,
+    str s,
+    bool escape_double_quotes = false,
+    bool escape_per_cent_signs = false
+);
+
+/// Same as Escape(), but append the result to a string builder.
+void EscapeInto(
+    StringBuilder& out,
+    str s,
+    bool escape_double_quotes = false,
+    bool escape_per_cent_signs = false
+);
+
 /// Escape elements in a range that need escaping.
 template <typename Range>
 auto escaped(Range&& r, bool escape_double_quotes) {
@@ -23,6 +40,9 @@ auto escaped(Range&& r, bool escape_double_quotes) {
 /// Indent a string.
 auto Indent(str s, u32 width) -> std::string;
 
+/// Same as Indent(), but append the result to a string builder.
+void IndentInto(StringBuilder& out, str s, u32 width);
+
 /// Join a range of strings.
 ///
 /// \param range The range whose elements should be joined.
@@ -7,6 +7,42 @@
 #include <concepts>
 #include <format>
 #include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace base::detail {
+// Unicode property tables; these are generated by
+// tools/GenerateUnicodeTables.py and defined in src/text/UnicodeTables.inc.
+extern const u8 CategoryStage1[];
+extern const u8 CategoryStage2[];
+extern const u8 XIDStage1[];
+extern const u8 XIDStage2[];
+extern const u8 LowerStage1[];
+extern const u8 LowerStage2[];
+extern const i32 LowerDeltas[];
+extern const u8 UpperStage1[];
+extern const u8 UpperStage2[];
+extern const i32 UpperDeltas[];
+extern const u8 WidthStage1[];
+extern const u8 WidthStage2[];
+extern const u8 WideStage1[];
+extern const u8 WideStage2[];
+
+/// Look up the value of a code point in a two-stage property table.
+///
+/// The first stage maps each block of 256 code points to a block of the
+/// second stage, which stores 'Bits' bits per code point. Values that
+/// are out of range map to 0.
+template <unsigned Bits>
+[[nodiscard]] auto LookupProperty(const u8* stage1, const u8* stage2, char32_t c) noexcept -> u8 {
+    static constexpr unsigned PerByte = 8 / Bits;
+    if (c > 0x10'FFFF) [[unlikely]] return 0;
+    auto block = usz(stage1[c / 256]);
+    auto bits = stage2[block * (256 / PerByte) + c % 256 / PerByte];
+    return u8(bits >> (c % PerByte * Bits) & ((1u << Bits) - 1));
+}
+} // namespace base::detail
 
 namespace base::text {
 enum struct NormalisationForm {
@@ -61,34 +97,61 @@ struct c32 {
     constexpr c32(char32_t value) noexcept : value(value) {}
     explicit constexpr c32(std::integral auto value) noexcept : value(char32_t(value)) {}
 
-#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
     /// Get the category of a character.
-    [[nodiscard]] auto category() const noexcept -> CharCategory;
+    [[nodiscard]] auto category() const noexcept -> CharCategory {
+        return CharCategory(detail::LookupProperty<8>(detail::CategoryStage1, detail::CategoryStage2, value));
+    }
 
     /// Check if this is an XID_Continue character.
-    [[nodiscard]] bool is_xid_continue() const noexcept;
+    [[nodiscard]] bool is_xid_continue() const noexcept {
+        return detail::LookupProperty<2>(detail::XIDStage1, detail::XIDStage2, value) & 2;
+    }
 
     /// Check if this is an XID_Start character.
-    [[nodiscard]] bool is_xid_start() const noexcept;
+    [[nodiscard]] bool is_xid_start() const noexcept {
+        return detail::LookupProperty<2>(detail::XIDStage1, detail::XIDStage2, value) & 1;
+    }
 
+#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
     /// Get the name of a character.
     [[nodiscard]] auto name() const noexcept -> Result<std::string>;
+#endif
 
     /// Swap case.
-    [[nodiscard]] auto swap_case() const noexcept -> c32;
+    [[nodiscard]] auto swap_case() const noexcept -> c32 {
+        auto cat = category();
+        if (cat == CharCategory::UppercaseLetter) return to_lower();
+        if (cat == CharCategory::LowercaseLetter) return to_upper();
+        return *this;
+    }
 
     /// Convert to lower case.
-    [[nodiscard]] auto to_lower() const noexcept -> c32;
+    ///
+    /// This uses the simple case mapping; use ToLower() to convert
+    /// characters whose lowercase form is more than one character.
+    [[nodiscard]] auto to_lower() const noexcept -> c32 {
+        auto i = detail::LookupProperty<8>(detail::LowerStage1, detail::LowerStage2, value);
+        return char32_t(value + u32(detail::LowerDeltas[i]));
+    }
 
     /// Convert to upper case.
-    [[nodiscard]] auto to_upper() const noexcept -> c32;
+    ///
+    /// \see to_lower()
+    [[nodiscard]] auto to_upper() const noexcept -> c32 {
+        auto i = detail::LookupProperty<8>(detail::UpperStage1, detail::UpperStage2, value);
+        return char32_t(value + u32(detail::UpperDeltas[i]));
+    }
 
     /// Get the width of this character.
     ///
-    /// This is either 1 or 2. This property is only well-defined for
-    /// characters that have a fixed width.
-    [[nodiscard]] auto width() const noexcept -> unsigned;
-#endif
+    /// This is either 1 or 2, depending on the East_Asian_Width of the
+    /// character. This property is only well-defined for characters that
+    /// have a fixed width.
+    ///
+    /// \see ColumnWidth()
+    [[nodiscard]] auto width() const noexcept -> unsigned {
+        return detail::LookupProperty<1>(detail::WideStage1, detail::WideStage2, value) ? 2 : 1;
+    }
 
     constexpr c32& operator++() noexcept {
         ++value;
@@ -151,9 +214,44 @@ private:
     void destroy();
 };
 
+/// Pool of transliterators that share the same rules.
+///
+/// A Transliterator is expensive to create and can’t be used by several
+/// threads at the same time. The pool compiles the rules once and clones
+/// the result whenever a thread needs a transliterator and none of the
+/// ones created so far are free; this makes it safe to share a single
+/// pool between threads.
+class TransliteratorPool {
+    LIBBASE_DECLARE_HIDDEN_IMPL(TransliteratorPool);
+
+public:
+    /// Create a new transliterator pool.
+    ///
+    /// \throw std::runtime_error on error.
+    /// \see Create() for a non-throwing factory function.
+    explicit TransliteratorPool(std::string_view rules) { *this = std::move(Create(rules).value()); }
+
+    /// Create a new transliterator pool.
+    [[nodiscard]] static auto Create(std::string_view rules) -> Result<TransliteratorPool>;
+
+    /// Transliterate many strings at once.
+    ///
+    /// The strings are split evenly between 'threads' worker threads; if
+    /// 'threads' is 0, we use one thread per hardware thread.
+    [[nodiscard]] auto batch(std::span<const std::string_view> strings, usz threads = 0) const -> std::vector<std::string>;
+    [[nodiscard]] auto batch(std::span<const std::u32string_view> strings, usz threads = 0) const -> std::vector<std::u32string>;
+
+    /// Transliterate a string.
+    [[nodiscard]] auto operator()(std::string_view str) const -> std::string;
+    [[nodiscard]] auto operator()(std::u16string_view str) const -> std::u16string;
+    [[nodiscard]] auto operator()(std::u32string_view str) const -> std::u32string;
+};
+
 /// Find all characters whose name contains one of the given strings.
 ///
-/// If the query is empty, the result is unspecified.
+/// If the query is empty, the result is unspecified. This uses the index
+/// returned by CharNameIndex::Get(), so the first call has to build it;
+/// use CharNameIndex::find() for plain substring queries.
 [[nodiscard]] auto FindCharsByName(
     std::function<bool(c32, std::string_view)> filter,
     c32 from = u' ',
@@ -185,45 +283,29 @@ private:
 [[nodiscard]] constexpr bool IsOctal(char c) noexcept { return c >= '0' and c <= '7'; }
 
 /// \see ColumnWidth(std::u32string_view)
-usz ColumnWidth(std::string_view text)
-#if !defined(LIBBASE_ENABLE_UNICODE_SUPPORT) && !defined(LIBBASE_ENABLE_LLVM_BINDINGS_UNICODE)
-    = delete(
-        "The ColumnWidth(std::string_view) overload requires ICU or LLVM support to be enabled; "
-        "convert the text to UTF-32 and call ColumnWidth(std::u32string_view) instead"
-    );
-#endif
-;
+usz ColumnWidth(std::string_view text);
 
 /// Get the column width if possible.
 ///
-/// This function returns std::nullopt iff both LLVM and ICU support are disabled.
+/// ColumnWidth() is now always available, so this never returns
+/// std::nullopt; it is only kept for compatibility.
 inline std::optional<usz> TryGetColumnWidth(std::string_view text) {
-#if defined(LIBBASE_ENABLE_UNICODE_SUPPORT) || defined(LIBBASE_ENABLE_LLVM_BINDINGS_UNICODE)
     return ColumnWidth(text);
-#else
-    return std::nullopt;
-#endif
 }
 
 /// Get the column width of text.
 ///
-/// This function takes ANSI-escape sequences into account.
+/// This function takes ANSI-escape sequences into account. Control
+/// characters, combining marks, and other zero-width characters have
+/// a width of 0, wide and fullwidth characters a width of 2, and tabs
+/// a width of 4; all other characters have a width of 1.
 usz ColumnWidth(std::u32string_view text);
 
-#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
-/// Convert a string to a normalised form.
-[[nodiscard]] auto Normalise(std::string_view str, NormalisationForm form) -> std::string;
-[[nodiscard]] auto Normalise(std::u32string_view str, NormalisationForm form) -> std::u32string;
-
-/// Convert a string to lowercase.
-[[nodiscard]] auto ToLower(std::string_view str) -> std::string;
-[[nodiscard]] auto ToLower(std::u32string_view str) -> std::u32string;
-
-/// Convert a string to uppercase.
-[[nodiscard]] auto ToUpper(std::string_view str) -> std::string;
-[[nodiscard]] auto ToUpper(std::u32string_view str) -> std::u32string;
-
 /// Convert UTF-16/32 to UTF-8.
+///
+/// The conversion functions below don’t require ICU. Invalid code units
+/// and unpaired surrogates are replaced with U+FFFD; for UTF-8 input, each
+/// maximal subpart of an invalid sequence yields one replacement character.
 [[nodiscard]] auto ToUTF8(std::u16string_view str) -> std::string;
 [[nodiscard]] auto ToUTF8(std::u32string_view str) -> std::string;
 [[nodiscard]] auto ToUTF8(c32 c) -> std::string;
@@ -236,6 +318,51 @@ usz ColumnWidth(std::u32string_view text);
 /// Convert UTF-8/16 to UTF-32.
 [[nodiscard]] auto ToUTF32(std::string_view str) -> std::u32string;
 [[nodiscard]] auto ToUTF32(std::u16string_view str) -> std::u32string;
+
+/// Check that a string is valid UTF-8.
+///
+/// On error, the message includes the offset of the first invalid byte.
+[[nodiscard]] auto ValidateUTF8(std::string_view str) -> Result<>;
+
+#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
+/// Check if a string is in a normalisation form.
+///
+/// This is a lot cheaper than normalising the string and comparing the
+/// result; every string is in NormalisationForm::None.
+[[nodiscard]] bool IsNormalised(std::string_view str, NormalisationForm form);
+[[nodiscard]] bool IsNormalised(std::u32string_view str, NormalisationForm form);
+
+/// Convert a string to a normalised form.
+///
+/// Parts of the string that are already normalised, in particular ASCII
+/// text, are copied as-is.
+[[nodiscard]] auto Normalise(std::string_view str, NormalisationForm form) -> std::string;
+[[nodiscard]] auto Normalise(std::u32string_view str, NormalisationForm form) -> std::u32string;
+
+/// Same as Normalise(), but append the result to a string.
+void NormaliseInto(std::string& out, std::string_view str, NormalisationForm form);
+void NormaliseInto(std::u32string& out, std::u32string_view str, NormalisationForm form);
+
+/// Convert a string to lowercase.
+///
+/// ASCII strings are converted without calling into ICU; this means that
+/// the case mapping of ASCII text never depends on the current locale.
+[[nodiscard]] auto ToLower(std::string_view str) -> std::string;
+[[nodiscard]] auto ToLower(std::u32string_view str) -> std::u32string;
+
+/// Same as ToLower(), but append the result to a string.
+void ToLowerInto(std::string& out, std::string_view str);
+void ToLowerInto(std::u32string& out, std::u32string_view str);
+
+/// Convert a string to uppercase.
+///
+/// \see ToLower()
+[[nodiscard]] auto ToUpper(std::string_view str) -> std::string;
+[[nodiscard]] auto ToUpper(std::u32string_view str) -> std::u32string;
+
+/// Same as ToUpper(), but append the result to a string.
+void ToUpperInto(std::string& out, std::string_view str);
+void ToUpperInto(std::u32string& out, std::u32string_view str);
 #endif
 } // namespace base::text
 
@@ -259,7 +386,6 @@ struct std::formatter<char32_t> : formatter<base::u32> {
     }
 };
 
-#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
 template <>
 struct std::formatter<std::u32string_view> : formatter<std::string_view> {
     template <typename FormatContext>
@@ -297,6 +423,5 @@ struct std::formatter<std::u16string> : formatter<std::u16string_view> {
         return formatter<std::u16string_view>::format(s, ctx);
     }
 };
-#endif
 
 #endif // LIBBASE_TEXT_HH
@@ -4,7 +4,12 @@
 #include <base/Assert.hh>
 #include <base/DSA.hh>
 #include <base/Macros.hh>
+#include <base/Result.hh>
+#include <base/Span.hh>
 #include <base/Types.hh>
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <queue>
 #include <ranges>
 #include <vector>
@@ -13,125 +18,98 @@ namespace base {
 template <typename CharType>
 class basic_trie;
 
+template <typename CharType>
+class basic_frozen_trie;
+
+template <typename CharType, usz NodeCount>
+class basic_static_trie;
+
 using trie = basic_trie<char>;
 using u8trie = basic_trie<char8_t>;
 using u16trie = basic_trie<char16_t>;
 using u32trie = basic_trie<char32_t>;
 using wtrie = basic_trie<wchar_t>;
-}
-
-/// Trie for performing string replacement.
-///
-/// This is intended to be used for matching multiple strings at
-/// once and replacing them all in a single pass over the input;
-/// if you’re only matching a single pattern or if all inputs and
-/// replacements are exactly one character, use stream::replace()
-/// or stream::replace_many() instead if possible.
-template <typename CharType>
-class base::basic_trie {
-public:
-    using char_type = CharType;
-    using text_type = std::basic_string_view<char_type>;
-    using string_type = std::basic_string<char_type>;
-
-private:
-    /// Type used to refer to a node.
-    using Node = u32;
-
-    /// A node for a single element in the trie.
-    struct NodeData {
-        /// Children of this node.
-        Map<char_type, Node> children;
-
-        /// Whether we have a replacement.
-        Node has_replacement : 1;
-
-        /// Depth of the node. The root node has depth 0.
-        Node depth : 31 = 0;
-
-        /// Index of the node that this node fails to.
-        Node fail = 0;
-    };
-
-    /// All nodes in the trie.
-    std::vector<NodeData> nodes{1};
-
-    /// Map from nodes to replacements; these are stored externally because
-    /// most nodes don’t have replacements, and storing an empty string in
-    /// them would just be a waste of memory.
-    Map<Node, string_type> replacements;
-
-    /// Index of the root node.
-    static constexpr Node Root = 0;
 
-    /// Whether we need to recompute the failure links.
-    bool dirty = false;
+using frozen_trie = basic_frozen_trie<char>;
+using u8frozen_trie = basic_frozen_trie<char8_t>;
+using u16frozen_trie = basic_frozen_trie<char16_t>;
+using u32frozen_trie = basic_frozen_trie<char32_t>;
 
-public:
-    /// Construct a new trie.
-    explicit basic_trie() = default;
+template <usz NodeCount> using static_trie = basic_static_trie<char, NodeCount>;
+template <usz NodeCount> using u8static_trie = basic_static_trie<char8_t, NodeCount>;
+template <usz NodeCount> using u16static_trie = basic_static_trie<char16_t, NodeCount>;
+template <usz NodeCount> using u32static_trie = basic_static_trie<char32_t, NodeCount>;
 
-    /// Construct a trie from pairs.
-    basic_trie(std::initializer_list<std::pair<text_type, text_type>> pairs) {
-        for (auto [from, to] : pairs) add(from, to);
-        update();
-    }
+/// Create a static trie whose node count is computed from its entries.
+///
+/// 'Entries' must be a lambda that returns a range of pairs of patterns
+/// and replacements, e.g.
+///
+///     static constexpr auto Escapes = MakeStaticTrie<[] {
+///         return std::to_array<std::pair<std::string_view, std::string_view>>({
+///             {"<", "&lt;"},
+///             {">", "&gt;"},
+///         });
+///     }>();
+///
+template <auto Entries>
+consteval auto MakeStaticTrie();
 
-    /// Add a new pattern to the trie.
-    ///
-    /// If the pattern already exists, the output text
-    /// is replaced with the new one.
-    void add(text_type pattern, text_type replacement) {
-        auto current = Root;
+namespace ser {
+template <typename T>
+struct Serialiser;
+}
 
-        // Insert the pattern into the trie.
-        for (auto [i, el] : utils::enumerate(pattern)) {
-            if (auto ch = child(current, el)) current = *ch;
-            else current = nodes[current].children[el] = allocate();
-            nodes[current].depth = usz(i + 1);
-        }
+namespace detail {
+struct TrieAccess;
 
-        replacements[current] = string_type(replacement);
-        nodes[current].has_replacement = true;
-    }
+template <typename CharType>
+class StaticTrieBuilder;
+}
+}
 
+/// ====================================================================
+///  Matching
+/// ====================================================================
+/// The matching algorithms are shared between the mutable trie and the
+/// frozen trie; both expose the same set of private accessors to this.
+struct base::detail::TrieAccess {
     /// Check if the trie contains a pattern and return its replacement.
-    auto get(text_type pattern) const -> std::optional<text_type> {
-        auto current = Root;
+    template <typename Trie>
+    static constexpr auto Get(const Trie& t, typename Trie::text_type pattern) -> std::optional<typename Trie::text_type> {
+        auto current = Trie::Root;
         for (auto el : pattern) {
-            if (auto ch = child(current, el)) current = *ch;
+            if (auto ch = t.child(current, el)) current = *ch;
             else return std::nullopt;
         }
 
-        if (nodes[current].has_replacement) return std::optional(text_type(replacements.at(current)));
+        if (t.has_replacement(current)) return std::optional(t.replacement(current));
         return std::nullopt;
     }
 
-    /// Check if this trie contains a string that matches the start of
+    /// Check if the trie contains a string that matches the start of
     /// the input text.
-    bool is_prefix_of(text_type haystack) const {
-        auto current = Root;
+    template <typename Trie>
+    static constexpr bool IsPrefixOf(const Trie& t, typename Trie::text_type haystack) {
+        auto current = Trie::Root;
         for (auto el : haystack) {
-            if (nodes[current].has_replacement) return true;
-            if (auto ch = child(current, el)) current = *ch;
+            if (t.has_replacement(current)) return true;
+            if (auto ch = t.child(current, el)) current = *ch;
             else return false;
         }
-        return nodes[current].has_replacement;
+        return t.has_replacement(current);
     }
 
     /// Replace all occurrences of the patterns in the trie in the input.
-    ///
-    /// This function always returns a copy because replacing elements means
-    /// that we will most likely have to move and reallocate anyway, so it’s
-    /// cheaper to just allocate one range instead of moving elements around
-    /// constantly.
-    auto replace(text_type input) -> string_type {
-        if (dirty) update();
+    template <typename Trie>
+    static constexpr auto Replace(const Trie& t, typename Trie::text_type input) -> typename Trie::string_type {
+        using Node = Trie::Node;
+        constexpr Node Root = Trie::Root;
         const auto sz = u32(input.size());
         const auto end = input.end();
         auto it = input.begin();
         auto current = Root;
-        string_type out;
+        typename Trie::string_type out;
         Node match_node = Root;
         out.reserve(sz); // Conservative estimate.
 
@@ -158,7 +136,7 @@ public:
             // We need to check this here instead of after we advance below to
             // make sure we recompute this property when we fail and reexamine
             // the current character.
-            if (nodes[current].has_replacement)
+            if (t.has_replacement(current))
                 match_node = current;
 
             // Go to the child node if there is one.
@@ -167,7 +145,7 @@ public:
             // may end up having to backtrack even after reaching the end.
             if (it != end) {
                 const auto c = *it;
-                if (auto ch = child(current, c)) {
+                if (auto ch = t.child(current, c)) {
                     current = *ch;
                     ++it;
                     continue;
@@ -178,12 +156,12 @@ public:
             //
             // Note that 'current' is the node corresponding to the *previous*
             // character, i.e. the character at 'it - 1'.
-            const auto current_depth = nodes[current].depth;
+            const auto current_depth = t.depth(current);
 
             // We have a match.
             if (match_node != Root) {
                 // Append the replacement text.
-                out += replacements.at(match_node);
+                out += t.replacement(match_node);
 
                 // Backtrack to to the end of the current match.
                 //
@@ -193,14 +171,14 @@ public:
                 // backtrack to right after it so we can match the "tba" as well;
                 // for this to work, backtracking is necessary, and we can’t use
                 // failure links or anything like that for this...
-                it = it - current_depth + nodes[match_node].depth;
+                it = it - current_depth + t.depth(match_node);
                 current = match_node = Root;
                 continue;
             }
 
             // We don’t have a match; follow the failure link.
             const auto prev = current;
-            const auto fail = current = nodes[current].fail;
+            const auto fail = current = t.fail_link(current);
 
             // We fail to the root.
             if (fail == Root) {
@@ -224,9 +202,110 @@ public:
             // That is, if we’re failing to a node with depth 'N', after buffering
             // up M characters, we need to append 'M - N' characters, starting at
             // the index where we last began traversing the trie.
-            out.append(it - current_depth, it - nodes[fail].depth);
+            out.append(it - current_depth, it - t.depth(fail));
         }
     }
+};
+
+/// Trie for performing string replacement.
+///
+/// This is intended to be used for matching multiple strings at
+/// once and replacing them all in a single pass over the input;
+/// if you’re only matching a single pattern or if all inputs and
+/// replacements are exactly one character, use stream::replace()
+/// or stream::replace_many() instead if possible.
+template <typename CharType>
+class base::basic_trie {
+    friend detail::TrieAccess;
+    friend ser::Serialiser<basic_trie>;
+
+public:
+    using char_type = CharType;
+    using text_type = std::basic_string_view<char_type>;
+    using string_type = std::basic_string<char_type>;
+
+private:
+    /// Type used to refer to a node.
+    using Node = u32;
+
+    /// A node for a single element in the trie.
+    struct NodeData {
+        /// Children of this node.
+        Map<char_type, Node> children;
+
+        /// Whether we have a replacement.
+        Node has_replacement : 1;
+
+        /// Depth of the node. The root node has depth 0.
+        Node depth : 31 = 0;
+
+        /// Index of the node that this node fails to.
+        Node fail = 0;
+    };
+
+    /// All nodes in the trie.
+    std::vector<NodeData> nodes{1};
+
+    /// Map from nodes to replacements; these are stored externally because
+    /// most nodes don’t have replacements, and storing an empty string in
+    /// them would just be a waste of memory.
+    Map<Node, string_type> replacements;
+
+    /// Index of the root node.
+    static constexpr Node Root = 0;
+
+    /// Whether we need to recompute the failure links.
+    bool dirty = false;
+
+public:
+    /// Construct a new trie.
+    explicit basic_trie() = default;
+
+    /// Construct a trie from pairs.
+    basic_trie(std::initializer_list<std::pair<text_type, text_type>> pairs) {
+        for (auto [from, to] : pairs) add(from, to);
+        update();
+    }
+
+    /// Add a new pattern to the trie.
+    ///
+    /// If the pattern already exists, the output text
+    /// is replaced with the new one.
+    void add(text_type pattern, text_type replacement) {
+        auto current = Root;
+
+        // Insert the pattern into the trie.
+        for (auto [i, el] : utils::enumerate(pattern)) {
+            if (auto ch = child(current, el)) current = *ch;
+            else current = nodes[current].children[el] = allocate();
+            nodes[current].depth = usz(i + 1);
+        }
+
+        replacements[current] = string_type(replacement);
+        nodes[current].has_replacement = true;
+    }
+
+    /// Check if the trie contains a pattern and return its replacement.
+    auto get(text_type pattern) const -> std::optional<text_type> {
+        return detail::TrieAccess::Get(*this, pattern);
+    }
+
+    /// Check if this trie contains a string that matches the start of
+    /// the input text.
+    bool is_prefix_of(text_type haystack) const {
+        return detail::TrieAccess::IsPrefixOf(*this, haystack);
+    }
+
+    /// Replace all occurrences of the patterns in the trie in the input.
+    ///
+    /// This function always returns a copy because replacing elements means
+    /// that we will most likely have to move and reallocate anyway, so it’s
+    /// cheaper to just allocate one range instead of moving elements around
+    /// constantly.
+    auto replace(text_type input) -> string_type {
+        if (dirty) update();
+        return detail::TrieAccess::Replace(*this, input);
+    }
 
 private:
     /// Allocate a new node.
@@ -244,6 +323,18 @@ private:
         return it->second;
     }
 
+    /// Get the depth of a node.
+    auto depth(Node node) const -> Node { return nodes[node].depth; }
+
+    /// Get the node that a node fails to.
+    auto fail_link(Node node) const -> Node { return nodes[node].fail; }
+
+    /// Check whether a node has a replacement.
+    bool has_replacement(Node node) const { return nodes[node].has_replacement; }
+
+    /// Get the replacement text of a node.
+    auto replacement(Node node) const -> text_type { return replacements.at(node); }
+
     /// Get the root node.
     auto root() -> NodeData& { return nodes[0]; }
 
@@ -295,4 +386,599 @@ private:
     }
 };
 
+/// Read-only trie that operates directly on serialised data.
+///
+/// Serialising a 'basic_trie' produces a flat, position-independent
+/// table that contains the nodes, the edges (sorted by character, so
+/// lookups are a binary search), the failure links, and the replacement
+/// texts. Deserialising a 'basic_frozen_trie' from that data doesn’t copy
+/// or allocate anything; instead, the frozen trie refers to the input
+/// buffer directly, so it can be loaded straight out of a mapped file:
+///
+///     auto file = Try(File::Read(path));
+///     auto t = Try(ser::Deserialise<frozen_trie, std::endian::native>(file.span()));
+///
+/// The buffer must outlive the trie. Since no byte-swapping is performed
+/// on lookup, the data must have been serialised in native endianness and
+/// with the fixed encoding.
+template <typename CharType>
+class base::basic_frozen_trie {
+    friend detail::TrieAccess;
+    friend ser::Serialiser<basic_frozen_trie>;
+
+public:
+    using char_type = CharType;
+    using text_type = std::basic_string_view<char_type>;
+    using string_type = std::basic_string<char_type>;
+
+private:
+    using Node = u32;
+
+    /// Layout of a node in the serialised data.
+    struct NodeData {
+        /// Depth of the node; the top bit is set if the node has a replacement.
+        u32 depth_and_flag;
+
+        /// Index of the node that this node fails to.
+        u32 fail;
+
+        /// Index of the first outgoing edge.
+        u32 first_edge;
+
+        /// Number of outgoing edges.
+        u32 edge_count;
+
+        /// Offset and size of the replacement text, in characters.
+        u32 replacement_offset;
+        u32 replacement_size;
+    };
+
+    /// Layout of an edge in the serialised data.
+    struct EdgeData {
+        u32 character;
+        Node target;
+    };
+
+    static_assert(sizeof(NodeData) == 6 * sizeof(u32));
+    static_assert(sizeof(EdgeData) == 2 * sizeof(u32));
+    static constexpr u32 ReplacementFlag = u32(1) << 31;
+    static constexpr Node Root = 0;
+
+    const std::byte* node_data;
+    const std::byte* edge_data;
+    const char_type* text_data;
+    u32 node_count;
+    u32 edge_count;
+    u32 text_size;
+
+    basic_frozen_trie(ByteSpan nodes, ByteSpan edges, ByteSpan text, u32 node_count, u32 edge_count, u32 text_size)
+        : node_data{nodes.data()},
+          edge_data{edges.data()},
+          text_data{reinterpret_cast<const char_type*>(text.data())},
+          node_count{node_count},
+          edge_count{edge_count},
+          text_size{text_size} {}
+
+public:
+    /// Get the number of nodes in this trie.
+    [[nodiscard]] auto size() const -> usz { return node_count; }
+
+    /// Check if the trie contains a pattern and return its replacement.
+    auto get(text_type pattern) const -> std::optional<text_type> {
+        return detail::TrieAccess::Get(*this, pattern);
+    }
+
+    /// Check if this trie contains a string that matches the start of
+    /// the input text.
+    bool is_prefix_of(text_type haystack) const {
+        return detail::TrieAccess::IsPrefixOf(*this, haystack);
+    }
+
+    /// Replace all occurrences of the patterns in the trie in the input.
+    ///
+    /// \see basic_trie::replace()
+    auto replace(text_type input) const -> string_type {
+        return detail::TrieAccess::Replace(*this, input);
+    }
+
+private:
+    /// Read a node or edge out of the buffer; the data need not be
+    /// suitably aligned for direct access.
+    template <typename T>
+    static auto Load(const std::byte* base, usz index) -> T {
+        T value;
+        std::memcpy(&value, base + index * sizeof(T), sizeof(T));
+        return value;
+    }
+
+    auto node(Node n) const -> NodeData { return Load<NodeData>(node_data, n); }
+
+    /// Get the child of a node.
+    auto child(Node node, char_type c) const -> std::optional<Node> {
+        auto n = this->node(node);
+        auto key = u32(std::make_unsigned_t<char_type>(c));
+        auto lo = n.first_edge;
+        auto hi = n.first_edge + n.edge_count;
+        while (lo < hi) {
+            auto mid = lo + (hi - lo) / 2;
+            auto e = Load<EdgeData>(edge_data, mid);
+            if (e.character == key) return e.target;
+            if (e.character < key) lo = mid + 1;
+            else hi = mid;
+        }
+        return std::nullopt;
+    }
+
+    auto depth(Node n) const -> Node { return node(n).depth_and_flag & ~ReplacementFlag; }
+    auto fail_link(Node n) const -> Node { return node(n).fail; }
+    bool has_replacement(Node n) const { return node(n).depth_and_flag & ReplacementFlag; }
+    auto replacement(Node n) const -> text_type {
+        auto data = node(n);
+        return text_type{text_data + data.replacement_offset, data.replacement_size};
+    }
+};
+
+/// ====================================================================
+///  Static Tries
+/// ====================================================================
+/// Helper to build tries at compile time.
+///
+/// This builds a pointer-based trie and then flattens it in BFS order,
+/// so that the children of each node are contiguous and sorted by their
+/// character. The static trie types copy the flattened nodes into a
+/// fixed-size array.
+template <typename CharType>
+class base::detail::StaticTrieBuilder {
+public:
+    using text_type = std::basic_string_view<CharType>;
+    static constexpr u32 NoEntry = u32(-1);
+
+    /// A node in the flattened trie.
+    struct Node {
+        /// The character on the edge leading to this node.
+        CharType ch{};
+
+        /// Index of the first child and number of children.
+        u32 first_child = 0;
+        u32 child_count = 0;
+
+        /// Depth of the node. The root node has depth 0.
+        u32 depth = 0;
+
+        /// Index of the entry that ends at this node, if any.
+        u32 entry = NoEntry;
+    };
+
+private:
+    struct TreeNode {
+        std::vector<std::pair<CharType, u32>> children;
+        u32 depth = 0;
+        u32 entry = NoEntry;
+    };
+
+    std::vector<TreeNode> tree{1};
+
+public:
+    /// Count the number of nodes required for a set of entries.
+    static constexpr auto CountNodes(const auto& entries) -> usz {
+        StaticTrieBuilder b;
+        for (const auto& e : entries) b.add(text_type(e.first), 0);
+        return b.tree.size();
+    }
+
+    /// Add a pattern; if it already exists, its entry is replaced.
+    constexpr void add(text_type pattern, u32 entry) {
+        u32 current = 0;
+        for (auto c : pattern) {
+            auto& children = tree[current].children;
+            auto it = rgs::find(children, c, &std::pair<CharType, u32>::first);
+            if (it != children.end()) {
+                current = it->second;
+                continue;
+            }
+
+            auto next = u32(tree.size());
+            children.emplace_back(c, next);
+            tree.emplace_back();
+            tree.back().depth = tree[current].depth + 1;
+            current = next;
+        }
+
+        tree[current].entry = entry;
+    }
+
+    /// Flatten the trie in BFS order.
+    constexpr auto flatten() const -> std::vector<Node> {
+        std::vector<Node> out;
+        std::vector<u32> queue{0};
+        out.reserve(tree.size());
+        out.emplace_back();
+        out.front().entry = tree.front().entry;
+        for (usz i = 0; i < queue.size(); i++) {
+            auto children = tree[queue[i]].children;
+            rgs::sort(children);
+            out[i].first_child = u32(out.size());
+            out[i].child_count = u32(children.size());
+            for (auto [c, index] : children) {
+                auto& n = out.emplace_back();
+                n.ch = c;
+                n.depth = tree[index].depth;
+                n.entry = tree[index].entry;
+                queue.push_back(index);
+            }
+        }
+        return out;
+    }
+};
+
+/// Trie for performing string replacement that is built at compile time.
+///
+/// This supports the same operations as 'basic_trie', but its nodes are
+/// stored in an array of fixed size, so it requires no allocation and
+/// can be declared 'constexpr'. 'NodeCount' must be at least the number
+/// of nodes in the trie; use 'MakeStaticTrie()' to compute it.
+///
+/// The replacement texts are not copied, so they must have static storage
+/// duration, which is always the case for string literals.
+template <typename CharType, base::usz NodeCount>
+class base::basic_static_trie {
+    friend detail::TrieAccess;
+
+public:
+    using char_type = CharType;
+    using text_type = std::basic_string_view<char_type>;
+    using string_type = std::basic_string<char_type>;
+
+private:
+    using Node = u32;
+    using Builder = detail::StaticTrieBuilder<char_type>;
+    static constexpr Node Root = 0;
+
+    struct NodeData {
+        char_type ch{};
+        u32 first_child{};
+        u32 child_count{};
+        u32 depth{};
+        Node fail{};
+        bool has_replacement{};
+        text_type replacement{};
+    };
+
+    std::array<NodeData, NodeCount> nodes{};
+
+public:
+    /// Construct a trie from pairs.
+    consteval basic_static_trie(std::initializer_list<std::pair<text_type, text_type>> pairs) {
+        init(pairs);
+    }
+
+    /// Construct a trie from a range of pairs.
+    template <rgs::input_range Range>
+    consteval explicit basic_static_trie(const Range& pairs) {
+        init(pairs);
+    }
+
+    /// Check if the trie contains a pattern and return its replacement.
+    constexpr auto get(text_type pattern) const -> std::optional<text_type> {
+        return detail::TrieAccess::Get(*this, pattern);
+    }
+
+    /// Check if this trie contains a string that matches the start of
+    /// the input text.
+    constexpr bool is_prefix_of(text_type haystack) const {
+        return detail::TrieAccess::IsPrefixOf(*this, haystack);
+    }
+
+    /// Replace all occurrences of the patterns in the trie in the input.
+    ///
+    /// \see basic_trie::replace()
+    constexpr auto replace(text_type input) const -> string_type {
+        return detail::TrieAccess::Replace(*this, input);
+    }
+
+private:
+    consteval void init(const auto& pairs) {
+        std::vector<std::pair<text_type, text_type>> entries;
+        for (const auto& [from, to] : pairs) entries.emplace_back(from, to);
+
+        Builder b;
+        for (auto [i, e] : utils::enumerate(entries)) b.add(e.first, u32(i));
+        auto flat = b.flatten();
+        Assert(flat.size() <= NodeCount, "Static trie needs at least {} nodes", flat.size());
+
+        for (auto [i, n] : utils::enumerate(flat)) {
+            auto& data = nodes[usz(i)];
+            data.ch = n.ch;
+            data.first_child = n.first_child;
+            data.child_count = n.child_count;
+            data.depth = n.depth;
+            if (n.entry != Builder::NoEntry) {
+                data.has_replacement = true;
+                data.replacement = entries[n.entry].second;
+            }
+        }
+
+        // Compute the failure links; see basic_trie::update() for a more detailed
+        // explanation. The nodes are in BFS order, so the fail link of a node’s
+        // parent is always known by the time we get to the node itself, and the
+        // children of the root already fail to the root.
+        for (usz i = 1; i < flat.size(); i++) {
+            for (auto c = nodes[i].first_child; c < nodes[i].first_child + nodes[i].child_count; c++) {
+                for (auto f = nodes[i].fail; /* nothing */; f = nodes[f].fail) {
+                    if (auto ch = child(f, nodes[c].ch)) {
+                        nodes[c].fail = *ch;
+                        break;
+                    }
+
+                    if (f == Root) {
+                        nodes[c].fail = Root;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    /// Get the child of a node.
+    constexpr auto child(Node node, char_type c) const -> std::optional<Node> {
+        auto& n = nodes[node];
+        auto begin = nodes.begin() + n.first_child;
+        auto end = begin + n.child_count;
+        auto it = std::lower_bound(begin, end, c, [](const NodeData& d, char_type ch) { return d.ch < ch; });
+        if (it == end or it->ch != c) return std::nullopt;
+        return Node(it - nodes.begin());
+    }
+
+    constexpr auto depth(Node n) const -> Node { return nodes[n].depth; }
+    constexpr auto fail_link(Node n) const -> Node { return nodes[n].fail; }
+    constexpr bool has_replacement(Node n) const { return nodes[n].has_replacement; }
+    constexpr auto replacement(Node n) const -> text_type { return nodes[n].replacement; }
+};
+
+template <auto Entries>
+consteval auto base::MakeStaticTrie() {
+    using Entry = rgs::range_value_t<decltype(Entries())>;
+    using Char = Entry::first_type::value_type;
+    constexpr usz NodeCount = detail::StaticTrieBuilder<Char>::CountNodes(Entries());
+    return basic_static_trie<Char, NodeCount>(Entries());
+}
+
+/// ====================================================================
+///  Serialisation
+/// ====================================================================
+/// A serialised trie consists of a header that contains the number of
+/// nodes, edges, and replacement characters, followed by three tables:
+///
+///   1. The nodes, in the 'basic_frozen_trie::NodeData' layout.
+///   2. The edges, in the 'basic_frozen_trie::EdgeData' layout, grouped
+///      by node and sorted by character.
+///   3. The replacement texts of all nodes, concatenated.
+///
+/// Every field is a 'u32'; all references are indices into these tables,
+/// which makes the layout position-independent.
+///
+/// This flat layout is only defined for 'Encoding::Fixed': with varints,
+/// the mutable trie can still be serialised, but every field is encoded
+/// as a varint, so the result can’t be loaded as a frozen trie.
+template <typename CharType>
+struct base::ser::Serialiser<base::basic_trie<CharType>> {
+    using Trie = basic_trie<CharType>;
+    using Char = CharType;
+
+    static auto deserialise(auto& r) -> Result<Trie> {
+        Trie t;
+        auto node_count = Try(r.template read<u32>());
+        auto edge_count = Try(r.template read<u32>());
+        auto text_size = Try(r.template read<u32>());
+        if (node_count == 0) return Error("A serialised trie must contain at least one node");
+
+        // Make sure the counts can actually fit in the input before we
+        // allocate anything for them. If we’re reading from a source, we
+        // can’t know that up front, so let the vectors grow as we read.
+        constexpr u64 FieldSize = r.encoding() == decltype(r.encoding())::Fixed ? sizeof(u32) : 1;
+        const bool preallocate = not r.has_source();
+        if (preallocate) {
+            u64 min_size = u64(node_count) * 6 * FieldSize + u64(edge_count) * 2 * FieldSize + u64(text_size) * sizeof(Char);
+            if (min_size > r.size()) [[unlikely]] {
+                return Error(
+                    "Not enough data to read {} nodes, {} edges, and {} characters ({} bytes left)",
+                    node_count,
+                    edge_count,
+                    text_size,
+                    r.size()
+                );
+            }
+        }
+
+        // Read the nodes.
+        struct Info {
+            u32 first_edge, edge_count, replacement_offset, replacement_size;
+        };
+
+        std::vector<Info> info;
+        t.nodes.clear();
+        if (preallocate) {
+            info.reserve(node_count);
+            t.nodes.reserve(node_count);
+        }
+
+        for (u32 i = 0; i < node_count; i++) {
+            auto depth = Try(r.template read<u32>());
+            auto fail = Try(r.template read<u32>());
+            auto& n = info.emplace_back();
+            n.first_edge = Try(r.template read<u32>());
+            n.edge_count = Try(r.template read<u32>());
+            n.replacement_offset = Try(r.template read<u32>());
+            n.replacement_size = Try(r.template read<u32>());
+            if (fail >= node_count) return Error("Fail link {} of node {} is out of bounds", fail, i);
+            if (u64(n.first_edge) + n.edge_count > edge_count) return Error("Edges of node {} are out of bounds", i);
+            if (u64(n.replacement_offset) + n.replacement_size > text_size) return Error("Replacement of node {} is out of bounds", i);
+            auto& node = t.nodes.emplace_back();
+            node.depth = depth & ~(u32(1) << 31);
+            node.has_replacement = (depth >> 31) != 0;
+            node.fail = fail;
+        }
+
+        // Read the edges.
+        std::vector<std::pair<Char, u32>> edges;
+        if (preallocate) edges.reserve(edge_count);
+        for (u32 i = 0; i < edge_count; i++) {
+            auto c = Char(Try(r.template read<u32>()));
+            auto target = Try(r.template read<u32>());
+            if (target >= node_count) return Error("Edge target {} is out of bounds", target);
+            edges.emplace_back(c, target);
+        }
+
+        // Read the replacement text.
+        std::basic_string<Char> text;
+        if (preallocate) text.reserve(text_size);
+        for (u32 i = 0; i < text_size; i++) text += Try(r.template read<Char>());
+
+        // The trie isn’t dirty after loading, so replace() trusts the depths
+        // and fail links; make sure that following them always terminates
+        // and never backtracks past the start of the input.
+        if (t.nodes[Trie::Root].depth != 0) return Error("Root of serialised trie must have depth 0");
+
+        // And rebuild the trie.
+        for (u32 i = 0; i < node_count; i++) {
+            auto& n = info[i];
+            auto fail = t.nodes[i].fail;
+            if (i == Trie::Root ? fail != Trie::Root : t.nodes[fail].depth >= t.nodes[i].depth)
+                return Error("Fail link of node {} does not lead to a shallower node", i);
+            for (auto& [c, target] : std::span{edges}.subspan(n.first_edge, n.edge_count)) {
+                if (t.nodes[target].depth != u32(t.nodes[i].depth) + 1)
+                    return Error("Edge target {} of node {} has the wrong depth", target, i);
+                t.nodes[i].children[c] = target;
+            }
+            if (t.nodes[i].has_replacement)
+                t.replacements[i] = text.substr(n.replacement_offset, n.replacement_size);
+        }
+
+        return t;
+    }
+
+    static void serialise(auto& w, const Trie& trie) {
+        // Make sure the failure links are up-to-date.
+        if (trie.dirty) {
+            auto copy = trie;
+            copy.update();
+            return serialise(w, copy);
+        }
+
+        // Collect the edges; sort them by character for binary search.
+        std::vector<std::pair<u32, u32>> edges;
+        std::vector<u32> first_edge;
+        first_edge.reserve(trie.nodes.size());
+        for (const auto& n : trie.nodes) {
+            auto start = edges.size();
+            first_edge.push_back(u32(start));
+            for (auto [c, target] : n.children) edges.emplace_back(u32(std::make_unsigned_t<Char>(c)), target);
+            std::sort(edges.begin() + isz(start), edges.end());
+        }
+
+        u64 text_size = 0;
+        for (const auto& s : trie.replacements | vws::values) text_size += s.size();
+        w << u32(trie.nodes.size()) << u32(edges.size()) << u32(text_size);
+
+        // Write the nodes.
+        u32 offset = 0;
+        for (usz i = 0; i < trie.nodes.size(); i++) {
+            const auto& n = trie.nodes[i];
+            u32 size = n.has_replacement ? u32(trie.replacements.at(u32(i)).size()) : 0;
+            u32 next = i + 1 < trie.nodes.size() ? first_edge[i + 1] : u32(edges.size());
+            w << (u32(n.depth) | (n.has_replacement ? u32(1) << 31 : 0))
+              << u32(n.fail)
+              << first_edge[i]
+              << next - first_edge[i]
+              << offset
+              << size;
+            offset += size;
+        }
+
+        // Write the edges.
+        for (auto [c, target] : edges) w << c << target;
+
+        // Write the replacement texts in node order.
+        for (usz i = 0; i < trie.nodes.size(); i++) {
+            if (not trie.nodes[i].has_replacement) continue;
+            const auto& s = trie.replacements.at(u32(i));
+            if constexpr (sizeof(Char) == 1) w.append_bytes(s.data(), s.size());
+            else for (auto c : s) w << c;
+        }
+    }
+};
+
+template <typename CharType>
+struct base::ser::Serialiser<base::basic_frozen_trie<CharType>> {
+    using Trie = basic_frozen_trie<CharType>;
+    using NodeData = Trie::NodeData;
+    using EdgeData = Trie::EdgeData;
+
+    static auto deserialise(auto& r) -> Result<Trie> {
+        static_assert(r.encoding() == decltype(r.encoding())::Fixed, "Frozen tries can only be loaded from data with fixed encoding");
+        if constexpr (r.endianness() != std::endian::native) {
+            return Error("Frozen tries can only be loaded from data in native endianness");
+        } else {
+            // The trie refers to the data directly, but spans returned by a
+            // reader that reads from a source only live as long as its buffer.
+            if (r.has_source()) return Error("Frozen tries cannot be loaded from a source");
+            auto node_count = Try(r.template read<u32>());
+            auto edge_count = Try(r.template read<u32>());
+            auto text_size = Try(r.template read<u32>());
+            if (node_count == 0) return Error("A serialised trie must contain at least one node");
+            auto nodes = Try(r.read_bytes(usz(node_count) * sizeof(NodeData)));
+            auto edges = Try(r.read_bytes(usz(edge_count) * sizeof(EdgeData)));
+            auto text = Try(r.read_bytes(usz(text_size) * sizeof(CharType)));
+            if (reinterpret_cast<uptr>(text.data()) % alignof(CharType) != 0)
+                return Error("Replacement text of frozen trie is not suitably aligned");
+            Try(Validate(nodes.data(), edges.data(), node_count, edge_count, text_size));
+            return Trie{nodes, edges, text, node_count, edge_count, text_size};
+        }
+    }
+
+    static void serialise(auto& w, const Trie& trie) {
+        static_assert(w.endianness() == std::endian::native, "Frozen tries must be serialised in native endianness");
+        static_assert(w.encoding() == decltype(w.encoding())::Fixed, "Frozen tries must be serialised with fixed encoding");
+        w << trie.node_count << trie.edge_count << trie.text_size;
+        w.append_bytes(trie.node_data, usz(trie.node_count) * sizeof(NodeData));
+        w.append_bytes(trie.edge_data, usz(trie.edge_count) * sizeof(EdgeData));
+        w.append_bytes(trie.text_data, usz(trie.text_size) * sizeof(CharType));
+    }
+
+private:
+    /// Check that all references in the tables are in bounds.
+    ///
+    /// Lookups don’t check anything, so we need to do this once here. In
+    /// addition to the bounds checks that the mutable trie does, we also
+    /// check the depths: every edge must go one level deeper, and every
+    /// node other than the root must fail to a shallower node (the root
+    /// fails to itself); this ensures that following edges and fail links
+    /// always terminates.
+    static auto Validate(
+        const std::byte* nodes,
+        const std::byte* edges,
+        u32 node_count,
+        u32 edge_count,
+        u32 text_size
+    ) -> Result<> {
+        auto Depth = [&](u32 n) { return Trie::template Load<NodeData>(nodes, n).depth_and_flag & ~Trie::ReplacementFlag; };
+        if (Depth(Trie::Root) != 0) return Error("Root of frozen trie must have depth 0");
+        for (u32 i = 0; i < node_count; i++) {
+            auto n = Trie::template Load<NodeData>(nodes, i);
+            if (n.fail >= node_count) return Error("Fail link {} of node {} is out of bounds", n.fail, i);
+            if (i == Trie::Root ? n.fail != Trie::Root : Depth(n.fail) >= Depth(i))
+                return Error("Fail link of node {} does not lead to a shallower node", i);
+            if (u64(n.first_edge) + n.edge_count > edge_count) return Error("Edges of node {} are out of bounds", i);
+            if (u64(n.replacement_offset) + n.replacement_size > text_size) return Error("Replacement of node {} is out of bounds", i);
+            for (u32 e = n.first_edge; e < n.first_edge + n.edge_count; e++) {
+                auto target = Trie::template Load<EdgeData>(edges, e).target;
+                if (target >= node_count) return Error("Edge target {} is out of bounds", target);
+                if (Depth(target) != Depth(i) + 1) return Error("Edge target {} of node {} has the wrong depth", target, i);
+            }
+        }
+
+        return {};
+    }
+};
+
 #endif // LIBBASE_TRIE_HH
@@ -2,6 +2,10 @@
 #define LIBBASE_TRIEMAP_HH
 
 #include <base/DSA.hh>
+#include <base/Result.hh>
+#include <base/Trie.hh>
+#include <algorithm>
+#include <array>
 
 namespace base {
 template <typename CharType, typename ValueType>
@@ -21,32 +25,76 @@ using Trie32Map = BasicTrieMap<char32_t, ValueType>;
 
 template <typename ValueType>
 using TrieWMap = BasicTrieMap<wchar_t, ValueType>;
+
+template <typename CharType, typename ValueType, usz NodeCount>
+class BasicStaticTrieMap;
+
+template <typename ValueType, usz NodeCount>
+using StaticTrieMap = BasicStaticTrieMap<char, ValueType, NodeCount>;
+
+template <typename ValueType, usz NodeCount>
+using StaticTrie8Map = BasicStaticTrieMap<char8_t, ValueType, NodeCount>;
+
+template <typename ValueType, usz NodeCount>
+using StaticTrie16Map = BasicStaticTrieMap<char16_t, ValueType, NodeCount>;
+
+template <typename ValueType, usz NodeCount>
+using StaticTrie32Map = BasicStaticTrieMap<char32_t, ValueType, NodeCount>;
+
+/// Create a static trie map whose node count is computed from its entries.
+///
+/// 'Entries' must be a lambda that returns a range of pairs of patterns
+/// and values, e.g.
+///
+///     static constexpr auto Keywords = MakeStaticTrieMap<[] {
+///         return std::to_array<std::pair<std::string_view, Tk>>({
+///             {"if", Tk::If},
+///             {"else", Tk::Else},
+///         });
+///     }>();
+///
+template <auto Entries>
+consteval auto MakeStaticTrieMap();
+
+namespace ser {
+template <typename T>
+struct Serialiser;
+}
 }
 
 /// Map-like container from strings to values using a trie.
 ///
+/// This is a radix trie: chains of nodes that have only one child are
+/// merged into a single node, and each node stores the label of the edge
+/// that leads to it as a span in a buffer shared by all nodes.
+///
 /// Use this with str::match_prefix().
 template <typename CharType, typename ValueType>
 class base::BasicTrieMap {
+    friend ser::Serialiser<BasicTrieMap>;
     using TextType = std::basic_string_view<CharType>;
 
-    /// A node for a single element in the trie.
+    /// A node for a sequence of elements in the trie.
     struct Node {
-        /// Children of this node.
-        HashMap<CharType, usz> children;
+        /// Children of this node, sorted by the first character of their label.
+        std::vector<std::pair<CharType, u32>> children;
 
         /// The replacement text for this node, if any.
         std::optional<ValueType> replacement;
 
-        /// Depth of the node. The root node has depth 0.
-        usz depth = 0;
+        /// Offset and size of the label of this node in the label buffer.
+        u32 label_offset = 0;
+        u32 label_size = 0;
     };
 
+    /// Labels of all nodes.
+    std::basic_string<CharType> labels;
+
     /// All nodes in the trie.
     std::vector<Node> nodes{1};
 
     /// Index of the root node.
-    static constexpr usz Root = 0;
+    static constexpr u32 Root = 0;
 
 public:
     /// Construct a new trie.
@@ -63,11 +111,39 @@ public:
     /// is replaced with the new one.
     void add(TextType pattern, ValueType replacement) {
         auto current = Root;
-        for (auto [i, el] : utils::enumerate(pattern)) {
-            if (auto child = nodes[current].children.get(el)) current = *child;
-            else current = nodes[current].children[el] = allocate();
-            nodes[current].depth = usz(i + 1);
+        while (not pattern.empty()) {
+            auto& children = nodes[current].children;
+            auto it = rgs::lower_bound(children, pattern.front(), {}, &std::pair<CharType, u32>::first);
+            auto index = usz(it - children.begin());
+
+            // No edge starts with this character; add the rest of the pattern as a leaf.
+            if (it == children.end() or it->first != pattern.front()) {
+                auto leaf = allocate(u32(labels.size()), u32(pattern.size()));
+                labels += pattern;
+                nodes[current].children.emplace(nodes[current].children.begin() + isz(index), pattern.front(), leaf);
+                current = leaf;
+                break;
+            }
+
+            // Follow the edge as far as it matches.
+            auto child = it->second;
+            auto label = label_of(child);
+            auto common = usz(rgs::mismatch(label, pattern).in1 - label.begin());
+            pattern.remove_prefix(common);
+            if (common == label.size()) {
+                current = child;
+                continue;
+            }
+
+            // The pattern diverges in the middle of the edge; split it.
+            auto mid = allocate(nodes[child].label_offset, u32(common));
+            nodes[child].label_offset += u32(common);
+            nodes[child].label_size -= u32(common);
+            nodes[mid].children.emplace_back(label[common], child);
+            nodes[current].children[index].second = mid;
+            current = mid;
         }
+
         nodes[current].replacement = std::move(replacement);
     }
 
@@ -75,28 +151,261 @@ public:
     ///
     /// \see str::match_prefix().
     auto match_prefix(TextType pattern) const -> std::optional<std::pair<u32, ValueType>> {
+        auto [depth, value] = match_prefix_ptr(pattern);
+        if (not value) return std::nullopt;
+        return std::pair{depth, *value};
+    }
+
+    /// Same as match_prefix(), but return a pointer to the value instead of
+    /// copying it; the pointer is null if there is no match.
+    ///
+    /// The pointer is invalidated if the trie is modified.
+    auto match_prefix_ptr(TextType pattern) const -> std::pair<u32, const ValueType*> {
+        std::pair<u32, const ValueType*> last_match{0, nullptr};
         auto current = Root;
-        auto last_match = Root;
-        for (auto el : pattern) {
-            if (nodes[current].replacement.has_value()) last_match = current;
-            if (auto child = nodes[current].children.get(el)) current = *child;
-            else break;
+        usz depth = 0;
+        for (;;) {
+            auto& n = nodes[current];
+            if (n.replacement.has_value()) last_match = {u32(depth), &*n.replacement};
+            if (depth == pattern.size()) break;
+
+            auto child = find_child(current, pattern[depth]);
+            if (not child) break;
+
+            auto label = label_of(*child);
+            if (not pattern.substr(depth).starts_with(label)) break;
+            depth += label.size();
+            current = *child;
         }
 
-        if (nodes[current].replacement.has_value()) last_match = current;
-        if (not nodes[last_match].replacement.has_value()) return std::nullopt;
-        return std::pair{nodes[last_match].depth, *nodes[last_match].replacement};
+        return last_match;
     }
 
 private:
     /// Allocate a new node.
-    auto allocate() -> usz {
-        nodes.emplace_back();
-        return nodes.size() - 1;
+    auto allocate(u32 label_offset, u32 label_size) -> u32 {
+        auto& n = nodes.emplace_back();
+        n.label_offset = label_offset;
+        n.label_size = label_size;
+        return u32(nodes.size() - 1);
+    }
+
+    /// Get the child of a node whose label starts with a character.
+    auto find_child(u32 node, CharType c) const -> std::optional<u32> {
+        auto& children = nodes[node].children;
+        auto it = rgs::lower_bound(children, c, {}, &std::pair<CharType, u32>::first);
+        if (it == children.end() or it->first != c) return std::nullopt;
+        return it->second;
+    }
+
+    /// Get the label of a node.
+    auto label_of(u32 node) const -> TextType {
+        return TextType{labels}.substr(nodes[node].label_offset, nodes[node].label_size);
+    }
+};
+
+/// Trie map that is built at compile time.
+///
+/// This is the same as 'BasicTrieMap', except that its nodes are stored
+/// in an array of fixed size, so it requires no allocation and can be
+/// declared 'constexpr'. 'NodeCount' must be at least the number of nodes
+/// in the trie; use 'MakeStaticTrieMap()' to compute it.
+template <typename CharType, typename ValueType, base::usz NodeCount>
+class base::BasicStaticTrieMap {
+    using TextType = std::basic_string_view<CharType>;
+    using Builder = detail::StaticTrieBuilder<CharType>;
+
+    /// A node for a single element in the trie.
+    struct Node {
+        CharType ch{};
+        u32 first_child{};
+        u32 child_count{};
+        u32 depth{};
+        bool has_value{};
+        ValueType value{};
+    };
+
+    /// All nodes in the trie, in BFS order.
+    std::array<Node, NodeCount> nodes{};
+
+public:
+    /// Construct a trie from pairs.
+    consteval BasicStaticTrieMap(std::initializer_list<std::pair<TextType, ValueType>> pairs) {
+        init(pairs);
     }
 
-    /// Get the root node.
-    auto root() -> Node& { return nodes[0]; }
+    /// Construct a trie from a range of pairs.
+    template <rgs::input_range Range>
+    consteval explicit BasicStaticTrieMap(const Range& pairs) {
+        init(pairs);
+    }
+
+    /// Check if the trie contains a pattern and return its replacement and depth.
+    ///
+    /// \see str::match_prefix().
+    constexpr auto match_prefix(TextType pattern) const -> std::optional<std::pair<u32, ValueType>> {
+        auto match = match_prefix_index(pattern);
+        if (not match.has_value()) return std::nullopt;
+        return std::pair{nodes[*match].depth, nodes[*match].value};
+    }
+
+    /// Same as match_prefix(), but return a pointer to the value instead of
+    /// copying it; the pointer is null if there is no match.
+    constexpr auto match_prefix_ptr(TextType pattern) const -> std::pair<u32, const ValueType*> {
+        auto match = match_prefix_index(pattern);
+        if (not match.has_value()) return {0, nullptr};
+        return {nodes[*match].depth, &nodes[*match].value};
+    }
+
+private:
+    /// Find the node of the longest pattern that matches the start of the input.
+    constexpr auto match_prefix_index(TextType pattern) const -> std::optional<u32> {
+        u32 current = 0;
+        std::optional<u32> last_match;
+        for (auto el : pattern) {
+            if (nodes[current].has_value) last_match = current;
+            if (auto child = find_child(current, el)) current = *child;
+            else break;
+        }
+
+        if (nodes[current].has_value) last_match = current;
+        return last_match;
+    }
+
+    consteval void init(const auto& pairs) {
+        std::vector<std::pair<TextType, ValueType>> entries;
+        for (const auto& [from, to] : pairs) entries.emplace_back(from, to);
+
+        Builder b;
+        for (auto [i, e] : utils::enumerate(entries)) b.add(e.first, u32(i));
+        auto flat = b.flatten();
+        Assert(flat.size() <= NodeCount, "Static trie map needs at least {} nodes", flat.size());
+
+        for (auto [i, n] : utils::enumerate(flat)) {
+            auto& data = nodes[usz(i)];
+            data.ch = n.ch;
+            data.first_child = n.first_child;
+            data.child_count = n.child_count;
+            data.depth = n.depth;
+            if (n.entry != Builder::NoEntry) {
+                data.has_value = true;
+                data.value = entries[n.entry].second;
+            }
+        }
+    }
+
+    /// Get the child of a node.
+    constexpr auto find_child(u32 node, CharType c) const -> std::optional<u32> {
+        auto& n = nodes[node];
+        auto begin = nodes.begin() + n.first_child;
+        auto end = begin + n.child_count;
+        auto it = std::lower_bound(begin, end, c, [](const Node& d, CharType ch) { return d.ch < ch; });
+        if (it == end or it->ch != c) return std::nullopt;
+        return u32(it - nodes.begin());
+    }
+};
+
+template <auto Entries>
+consteval auto base::MakeStaticTrieMap() {
+    using Entry = rgs::range_value_t<decltype(Entries())>;
+    using Char = Entry::first_type::value_type;
+    using Value = Entry::second_type;
+    constexpr usz NodeCount = detail::StaticTrieBuilder<Char>::CountNodes(Entries());
+    return BasicStaticTrieMap<Char, Value, NodeCount>(Entries());
+}
+
+/// Serialiser for trie maps.
+///
+/// This stores the label buffer and the nodes as-is so that loading a
+/// trie doesn’t have to rebuild it from the original patterns.
+template <typename CharType, typename ValueType>
+struct base::ser::Serialiser<base::BasicTrieMap<CharType, ValueType>> {
+    using TrieMap = BasicTrieMap<CharType, ValueType>;
+
+    static auto deserialise(auto& r) -> Result<TrieMap> {
+        TrieMap t;
+        t.labels = Try(r.template read<std::basic_string<CharType>>());
+        auto node_count = Try(r.template read<u32>());
+        if (node_count == 0) return Error("A serialised trie must contain at least one node");
+
+        // Don’t allocate anything for the nodes until we know that the input
+        // can hold them; each node has at least a label offset, a label size,
+        // a replacement flag, and a child count. If we’re reading from a
+        // source, we can’t know that up front, so grow the vectors instead.
+        constexpr u64 FieldSize = r.encoding() == decltype(r.encoding())::Fixed ? sizeof(u32) : 1;
+        const bool preallocate = not r.has_source();
+        if (preallocate) {
+            if (node_count > r.size() / (3 * FieldSize + sizeof(bool))) [[unlikely]] {
+                return Error(
+                    "Not enough data to read {} trie nodes ({} bytes left)",
+                    node_count,
+                    r.size()
+                );
+            }
+        }
+
+        t.nodes.clear();
+        if (preallocate) t.nodes.reserve(node_count);
+        for (u32 index = 0; index < node_count; index++) {
+            auto& n = t.nodes.emplace_back();
+            n.label_offset = Try(r.template read<u32>());
+            n.label_size = Try(r.template read<u32>());
+            n.replacement = Try(r.template read<std::optional<ValueType>>());
+            if (u64(n.label_offset) + n.label_size > t.labels.size())
+                return Error("Label of trie node is out of bounds");
+
+            // Lookups only make progress if every edge consumes input.
+            if (n.label_size == 0 and index != TrieMap::Root)
+                return Error("Label of trie node {} is empty", index);
+
+            // A node can’t have more children than there are other nodes.
+            auto children = Try(r.template read<u32>());
+            if (children >= node_count) return Error("Trie node {} has too many children", index);
+            if (preallocate) {
+                if (children > r.size() / (2 * FieldSize)) [[unlikely]] {
+                    return Error(
+                        "Not enough data to read {} children ({} bytes left)",
+                        children,
+                        r.size()
+                    );
+                }
+
+                n.children.reserve(children);
+            }
+
+            for (u32 i = 0; i < children; i++) {
+                auto c = CharType(Try(r.template read<u32>()));
+                auto child = Try(r.template read<u32>());
+                if (child >= node_count) return Error("Child index {} is out of bounds", child);
+                n.children.emplace_back(c, child);
+            }
+
+            if (not rgs::is_sorted(n.children)) return Error("Children of trie node are not sorted");
+        }
+
+        // Every node other than the root must have exactly one parent; this
+        // ensures that the nodes reachable from the root form a tree, so
+        // lookups can’t end up in a cycle. All nodes have been read at this
+        // point, so 'node_count' is known to be sane.
+        std::vector<bool> has_parent(node_count);
+        has_parent[TrieMap::Root] = true;
+        for (const auto& n : t.nodes) {
+            for (auto child : n.children | vws::values) {
+                if (has_parent[child]) return Error("Trie node {} has more than one parent", child);
+                has_parent[child] = true;
+            }
+        }
+
+        return t;
+    }
+
+    static void serialise(auto& w, const TrieMap& t) {
+        w << t.labels << u32(t.nodes.size());
+        for (const auto& n : t.nodes) {
+            w << n.label_offset << n.label_size << n.replacement << u32(n.children.size());
+            for (auto [c, child] : n.children) w << u32(std::make_unsigned_t<CharType>(c)) << child;
+        }
+    }
 };
 
 #endif // LIBBASE_TRIEMAP_HH
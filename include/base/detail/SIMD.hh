@@ -0,0 +1,28 @@
+#ifndef LIBBASE_DETAIL_SIMD_HH
+#define LIBBASE_DETAIL_SIMD_HH
+
+// Helpers for vectorised code paths. Only include this in source files,
+// never in public headers, since it pulls in the intrinsics headers.
+//
+// Vectorised code is compiled for a specific target using the 'target'
+// attribute and selected at runtime, so it is available even if the library
+// itself isn’t compiled with e.g. '-mavx2'.
+#if (defined(__x86_64__) or defined(__i386__)) and (defined(__GNUC__) or defined(__clang__))
+#    define LIBBASE_SIMD_X86
+#    define LIBBASE_TARGET_AVX2 __attribute__((target("avx2")))
+#    include <immintrin.h>
+#endif
+
+namespace base::detail {
+/// Check if the CPU we’re running on supports AVX2.
+inline bool HasAVX2() noexcept {
+#ifdef LIBBASE_SIMD_X86
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+} // namespace base::detail
+
+#endif // LIBBASE_DETAIL_SIMD_HH
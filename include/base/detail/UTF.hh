@@ -0,0 +1,146 @@
+#ifndef LIBBASE_DETAIL_UTF_HH
+#define LIBBASE_DETAIL_UTF_HH
+
+#include <base/Types.hh>
+#include <optional>
+#include <string_view>
+
+// Helpers for encoding and decoding individual code points; this
+// header is internal and should only be included in .cc files.
+
+namespace base::detail {
+constexpr char32_t ReplacementChar = U'\uFFFD';
+
+/// Get the number of code units at the start of a string that are ASCII.
+[[nodiscard]] auto AsciiPrefix(std::string_view str) -> usz;
+[[nodiscard]] auto AsciiPrefix(std::u16string_view str) -> usz;
+[[nodiscard]] auto AsciiPrefix(std::u32string_view str) -> usz;
+
+/// Check if a value is a code point that can be encoded.
+[[nodiscard]] constexpr bool IsScalarValue(char32_t c) {
+    return c < 0xD800 or (c > 0xDFFF and c <= 0x10'FFFF);
+}
+
+/// Decode a UTF-8 sequence and advance past it.
+///
+/// Returns std::nullopt if the sequence is invalid; in that case, we
+/// only advance past the maximal subpart of the sequence, as described
+/// in the WHATWG Encoding Standard.
+[[nodiscard]] inline auto TryDecodeUTF8(const char*& it, const char* end) -> std::optional<char32_t> {
+    auto b0 = u8(*it++);
+    if (b0 < 0x80) return b0;
+
+    // The range of the second byte excludes overlong encodings, surrogates,
+    // and values that are out of range.
+    usz len;
+    char32_t c;
+    u8 lo = 0x80, hi = 0xBF;
+    if (b0 >= 0xC2 and b0 <= 0xDF) {
+        len = 1;
+        c = char32_t(b0 & 0x1F);
+    } else if (b0 >= 0xE0 and b0 <= 0xEF) {
+        len = 2;
+        c = char32_t(b0 & 0x0F);
+        if (b0 == 0xE0) lo = 0xA0;
+        if (b0 == 0xED) hi = 0x9F;
+    } else if (b0 >= 0xF0 and b0 <= 0xF4) {
+        len = 3;
+        c = char32_t(b0 & 0x07);
+        if (b0 == 0xF0) lo = 0x90;
+        if (b0 == 0xF4) hi = 0x8F;
+    } else {
+        return std::nullopt;
+    }
+
+    for (usz i = 0; i < len; i++) {
+        if (it == end) return std::nullopt;
+        auto b = u8(*it);
+        if (b < lo or b > hi) return std::nullopt;
+        lo = 0x80;
+        hi = 0xBF;
+        c = c << 6 | char32_t(b & 0x3F);
+        ++it;
+    }
+
+    return c;
+}
+
+/// Same as TryDecodeUTF8(), but decodes invalid sequences as U+FFFD.
+[[nodiscard]] inline auto DecodeUTF8(const char*& it, const char* end) -> char32_t {
+    return TryDecodeUTF8(it, end).value_or(ReplacementChar);
+}
+
+/// Decode a UTF-16 sequence and advance past it; unpaired surrogates
+/// are decoded as U+FFFD.
+[[nodiscard]] inline auto DecodeUTF16(const char16_t*& it, const char16_t* end) -> char32_t {
+    char32_t c = *it++;
+    if (c < 0xD800 or c > 0xDFFF) return c;
+    if (c > 0xDBFF or it == end) return ReplacementChar;
+    char32_t lo = *it;
+    if (lo < 0xDC00 or lo > 0xDFFF) return ReplacementChar;
+    ++it;
+    return 0x1'0000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+}
+
+/// Decode a UTF-32 code unit and advance past it; invalid code points
+/// are decoded as U+FFFD.
+[[nodiscard]] inline auto DecodeUTF32(const char32_t*& it, const char32_t*) -> char32_t {
+    auto c = *it++;
+    return IsScalarValue(c) ? c : ReplacementChar;
+}
+
+/// Encode a code point as UTF-8.
+///
+/// 'out' must have room for 4 bytes. Returns the number of bytes written.
+inline auto EncodeUTF8(char32_t c, char* out) -> usz {
+    if (not IsScalarValue(c)) c = ReplacementChar;
+    if (c < 0x80) {
+        out[0] = char(c);
+        return 1;
+    }
+
+    if (c < 0x800) {
+        out[0] = char(0xC0 | c >> 6);
+        out[1] = char(0x80 | (c & 0x3F));
+        return 2;
+    }
+
+    if (c < 0x1'0000) {
+        out[0] = char(0xE0 | c >> 12);
+        out[1] = char(0x80 | (c >> 6 & 0x3F));
+        out[2] = char(0x80 | (c & 0x3F));
+        return 3;
+    }
+
+    out[0] = char(0xF0 | c >> 18);
+    out[1] = char(0x80 | (c >> 12 & 0x3F));
+    out[2] = char(0x80 | (c >> 6 & 0x3F));
+    out[3] = char(0x80 | (c & 0x3F));
+    return 4;
+}
+
+/// Encode a code point as UTF-16.
+///
+/// 'out' must have room for 2 code units. Returns the number of code
+/// units written.
+inline auto EncodeUTF16(char32_t c, char16_t* out) -> usz {
+    if (not IsScalarValue(c)) c = ReplacementChar;
+    if (c < 0x1'0000) {
+        out[0] = char16_t(c);
+        return 1;
+    }
+
+    c -= 0x1'0000;
+    out[0] = char16_t(0xD800 + (c >> 10));
+    out[1] = char16_t(0xDC00 + (c & 0x3FF));
+    return 2;
+}
+
+/// Encode a code point as UTF-32.
+inline auto EncodeUTF32(char32_t c, char32_t* out) -> usz {
+    out[0] = IsScalarValue(c) ? c : ReplacementChar;
+    return 1;
+}
+} // namespace base::detail
+
+#endif // LIBBASE_DETAIL_UTF_HH
@@ -0,0 +1,90 @@
+#include <base/CharSet.hh>
+#include <base/detail/SIMD.hh>
+#include <bit>
+
+using namespace base;
+
+namespace {
+auto FindFirstScalar(const CharSet& set, const char* data, usz size, bool negate) -> usz {
+    for (usz i = 0; i < size; i++)
+        if (set.contains(data[i]) != negate)
+            return i;
+    return size;
+}
+
+auto CountScalar(const CharSet& set, const char* data, usz size) -> usz {
+    usz n = 0;
+    for (usz i = 0; i < size; i++) n += set.contains(data[i]);
+    return n;
+}
+
+#ifdef LIBBASE_SIMD_X86
+/// Vectorised set membership test.
+///
+/// This uses the low nibble of each byte to look up a row in the bitmap,
+/// i.e. the set of high nibbles that are in the set for that low nibble,
+/// and then checks if the bit for the high nibble is set in that row.
+struct ClassifierAVX2 {
+    __m256i low_rows;
+    __m256i high_rows;
+
+    LIBBASE_TARGET_AVX2 explicit ClassifierAVX2(const u8* bits)
+        : low_rows{_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bits)))},
+          high_rows{_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + 16)))} {}
+
+    /// Get a mask of the bytes in a block of 32 bytes that are in the set.
+    LIBBASE_TARGET_AVX2 auto operator()(const char* data) const -> u32 {
+        const auto nibble = _mm256_set1_epi8(0x0F);
+        const auto bit_table = _mm256_setr_epi8(
+            1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+            1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128
+        );
+
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        auto lo = _mm256_and_si256(v, nibble);
+        auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+        auto row = _mm256_blendv_epi8(
+            _mm256_shuffle_epi8(low_rows, lo),
+            _mm256_shuffle_epi8(high_rows, lo),
+            _mm256_cmpgt_epi8(hi, _mm256_set1_epi8(7))
+        );
+
+        auto bit = _mm256_shuffle_epi8(bit_table, hi);
+        auto hit = _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+        return u32(_mm256_movemask_epi8(hit));
+    }
+};
+
+LIBBASE_TARGET_AVX2 auto FindFirstAVX2(const CharSet& set, const u8* bits, const char* data, usz size, bool negate) -> usz {
+    ClassifierAVX2 classify{bits};
+    const u32 flip = negate ? ~u32(0) : 0;
+    usz i = 0;
+    for (; i + 32 <= size; i += 32)
+        if (auto mask = classify(data + i) ^ flip)
+            return i + usz(std::countr_zero(mask));
+    return i + FindFirstScalar(set, data + i, size - i, negate);
+}
+
+LIBBASE_TARGET_AVX2 auto CountAVX2(const CharSet& set, const u8* bits, const char* data, usz size) -> usz {
+    ClassifierAVX2 classify{bits};
+    usz n = 0;
+    usz i = 0;
+    for (; i + 32 <= size; i += 32) n += usz(std::popcount(classify(data + i)));
+    return n + CountScalar(set, data + i, size - i);
+}
+#endif
+} // namespace
+
+auto base::detail::FindFirstInSet(const CharSet& set, const char* data, usz size, bool negate) noexcept -> usz {
+#ifdef LIBBASE_SIMD_X86
+    if (size >= 32 and HasAVX2()) return FindFirstAVX2(set, set.bits.data(), data, size, negate);
+#endif
+    return FindFirstScalar(set, data, size, negate);
+}
+
+auto base::detail::CountInSet(const CharSet& set, const char* data, usz size) noexcept -> usz {
+#ifdef LIBBASE_SIMD_X86
+    if (size >= 32 and HasAVX2()) return CountAVX2(set, set.bits.data(), data, size);
+#endif
+    return CountScalar(set, data, size);
+}
@@ -5,23 +5,27 @@
 
 using namespace base;
 
-auto detail::CompressImpl(
-    MutableByteSpan output,
-    ByteSpan input,
-    std::optional<int> compression_level
-) -> usz {
-    auto level = std::clamp(
+namespace {
+auto CompressionLevel(std::optional<int> compression_level) -> int {
+    return std::clamp(
         compression_level.value_or(ZSTD_defaultCLevel()),
         ZSTD_minCLevel(),
         ZSTD_maxCLevel()
     );
+}
+} // namespace
 
+auto detail::CompressImpl(
+    MutableByteSpan output,
+    ByteSpan input,
+    std::optional<int> compression_level
+) -> usz {
     auto size = ZSTD_compress(
         output.data(),
         output.size_bytes(),
         input.data(),
         input.size_bytes(),
-        level
+        CompressionLevel(compression_level)
     );
 
     Assert(
@@ -33,7 +37,7 @@ auto detail::CompressImpl(
     return size;
 }
 
-auto detail::DecompressImpl(MutableByteSpan output, ByteSpan input) -> Result<usz> {
+auto detail::DecompressImpl(MutableByteSpan output, ByteSpan input) -> Result<usz, CompactError> {
     auto size = ZSTD_decompress(
         output.data(),
         output.size_bytes(),
@@ -42,6 +46,7 @@ auto detail::DecompressImpl(MutableByteSpan output, ByteSpan input) -> Result<us
     );
 
     if (ZSTD_isError(size)) return Error(
+        ErrorCode::InvalidInput,
         "Decompression failed: {}",
         ZSTD_getErrorString(ZSTD_getErrorCode(size))
     );
@@ -53,13 +58,138 @@ usz detail::GetCompressedSize(ByteSpan input) {
     return ZSTD_compressBound(input.size());
 }
 
-auto detail::GetDecompressedSize(ByteSpan input) -> Result<usz> {
+auto detail::GetDecompressedSize(ByteSpan input) -> Result<usz, CompactError> {
     auto res = ZSTD_getFrameContentSize(input.data(), input.size());
     if (res == ZSTD_CONTENTSIZE_UNKNOWN) [[unlikely]]
-        return Error("Content size unknown: {}", ZSTD_getErrorString(ZSTD_getErrorCode(res)));
+        return Error(ErrorCode::InvalidInput, "Content size unknown: {}", ZSTD_getErrorString(ZSTD_getErrorCode(res)));
     if (res == ZSTD_CONTENTSIZE_ERROR) [[unlikely]]
-        return Error("Could not compute content size: {}", ZSTD_getErrorString(ZSTD_getErrorCode(res)));
+        return Error(ErrorCode::InvalidInput, "Could not compute content size: {}", ZSTD_getErrorString(ZSTD_getErrorCode(res)));
     return res;
 }
 
+/// ====================================================================
+///  Streaming
+/// ====================================================================
+struct CompressingSink::Impl {
+    std::function<Result<>(ByteSpan)> sink;
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx{ZSTD_createCCtx(), ZSTD_freeCCtx};
+    usz block_size;
+
+    /// Uncompressed data of the current block.
+    std::vector<std::byte> block;
+
+    /// Buffer for the compressed data.
+    std::vector<std::byte> compressed;
+
+    /// Compress the current block and write it to the sink.
+    auto write_block() -> Result<> {
+        if (block.empty()) return {};
+        compressed.resize(ZSTD_compressBound(block.size()));
+        auto size = ZSTD_compress2(
+            ctx.get(),
+            compressed.data(),
+            compressed.size(),
+            block.data(),
+            block.size()
+        );
+
+        Assert(
+            not ZSTD_isError(size),
+            "Compression failed: {}",
+            ZSTD_getErrorString(ZSTD_getErrorCode(size))
+        );
+
+        block.clear();
+        return sink(ByteSpan{compressed.data(), size});
+    }
+};
+
+CompressingSink::CompressingSink(
+    std::function<Result<>(ByteSpan)> sink,
+    usz block_size,
+    std::optional<int> compression_level,
+    bool checksums
+) : impl{std::make_unique<Impl>()} {
+    Assert(impl->ctx, "Failed to create compression context");
+    impl->sink = std::move(sink);
+    impl->block_size = std::max<usz>(block_size, 1);
+    impl->block.reserve(impl->block_size);
+    ZSTD_CCtx_setParameter(impl->ctx.get(), ZSTD_c_compressionLevel, CompressionLevel(compression_level));
+    ZSTD_CCtx_setParameter(impl->ctx.get(), ZSTD_c_checksumFlag, checksums);
+}
+
+CompressingSink::~CompressingSink() {
+    // Errors can only be observed by calling flush().
+    (void) flush();
+}
+
+auto CompressingSink::flush() -> Result<> {
+    return impl->write_block();
+}
+
+auto CompressingSink::write(ByteSpan data) -> Result<> {
+    while (not data.empty()) {
+        auto n = std::min(data.size(), impl->block_size - impl->block.size());
+        impl->block.insert(impl->block.end(), data.begin(), data.begin() + isz(n));
+        data = data.subspan(n);
+        if (impl->block.size() == impl->block_size) Try(impl->write_block());
+    }
+
+    return {};
+}
+
+struct DecompressingSource::Impl {
+    std::function<Result<usz>(MutableByteSpan)> source;
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx{ZSTD_createDCtx(), ZSTD_freeDCtx};
+
+    /// Compressed data that has been read from the source.
+    std::vector<std::byte> buffer;
+    ZSTD_inBuffer input{};
+
+    /// Whether we’re at the end of a frame.
+    bool frame_complete = true;
+
+    /// Whether the decompressor may still have output buffered.
+    bool flushing = false;
+};
+
+DecompressingSource::DecompressingSource(
+    std::function<Result<usz>(MutableByteSpan)> source,
+    usz chunk_size
+) : impl{std::make_unique<Impl>()} {
+    Assert(impl->ctx, "Failed to create decompression context");
+    impl->source = std::move(source);
+    impl->buffer.resize(std::max<usz>(chunk_size, 1));
+}
+
+DecompressingSource::~DecompressingSource() = default;
+
+auto DecompressingSource::read(MutableByteSpan into) -> Result<usz> {
+    ZSTD_outBuffer output{into.data(), into.size(), 0};
+    while (output.pos < output.size) {
+        // Only read more data once the decompressor has emitted everything
+        // it can produce from the data we already gave it.
+        if (impl->input.pos == impl->input.size and not impl->flushing) {
+            auto n = Try(impl->source(MutableByteSpan{impl->buffer}));
+            if (n == 0) {
+                if (not impl->frame_complete) return Error("Decompression failed: Compressed data is truncated");
+                break;
+            }
+
+            impl->input = {impl->buffer.data(), n, 0};
+        }
+
+        auto res = ZSTD_decompressStream(impl->ctx.get(), &output, &impl->input);
+        if (ZSTD_isError(res)) return Error(
+            "Decompression failed: {}",
+            ZSTD_getErrorString(ZSTD_getErrorCode(res))
+        );
+
+        impl->frame_complete = res == 0;
+        impl->flushing = output.pos == output.size;
+    }
+
+    return output.pos;
+}
+
 #endif // LIBBASE_ENABLE_ZSTD
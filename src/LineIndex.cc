@@ -0,0 +1,90 @@
+#include <base/LineIndex.hh>
+#include <base/detail/SIMD.hh>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+using namespace base;
+
+namespace {
+/// Below this, it’s not worth starting a thread.
+constexpr usz MinChunkSize = 1 << 20;
+
+/// Append the offset of the character after every newline in a text.
+template <typename OffsetType>
+void FindLineStartsScalar(const char* data, usz size, usz offset, std::vector<OffsetType>& out) {
+    for (const char* it = data, *end = data + size; it != end; it++) {
+        it = static_cast<const char*>(std::memchr(it, '\n', usz(end - it)));
+        if (not it) return;
+        out.push_back(OffsetType(offset + usz(it - data) + 1));
+    }
+}
+
+#ifdef LIBBASE_SIMD_X86
+/// Same as FindLineStartsScalar(), but processes 32 bytes at a time; this
+/// is faster than calling memchr() for every line if lines are short.
+template <typename OffsetType>
+LIBBASE_TARGET_AVX2 void FindLineStartsAVX2(const char* data, usz size, usz offset, std::vector<OffsetType>& out) {
+    const auto nl = _mm256_set1_epi8('\n');
+    usz i = 0;
+    for (; i + 32 <= size; i += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        for (auto mask = u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl))); mask; mask &= mask - 1)
+            out.push_back(OffsetType(offset + i + usz(std::countr_zero(mask)) + 1));
+    }
+
+    FindLineStartsScalar(data + i, size - i, offset + i, out);
+}
+#endif
+
+template <typename OffsetType>
+void FindLineStarts(const char* data, usz size, usz offset, std::vector<OffsetType>& out) {
+#ifdef LIBBASE_SIMD_X86
+    if (size >= 32 and detail::HasAVX2()) return FindLineStartsAVX2(data, size, offset, out);
+#endif
+    FindLineStartsScalar(data, size, offset, out);
+}
+} // namespace
+
+template <typename OffsetType>
+BasicLineIndex<OffsetType>::BasicLineIndex(str text, usz threads) : data{text} {
+    Assert(
+        text.size() <= usz(std::numeric_limits<OffsetType>::max()),
+        "Text is too large for this line index; use a wider offset type"
+    );
+
+    if (text.empty()) return;
+    starts.push_back(0);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, text.size() / MinChunkSize);
+    if (threads <= 1) {
+        FindLineStarts(text.data(), text.size(), 0, starts);
+        return;
+    }
+
+    // Each chunk is scanned into a separate vector; merge them afterwards
+    // so the offsets end up in order.
+    std::vector<std::vector<OffsetType>> chunks(threads);
+    const usz chunk_size = text.size() / threads;
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for (usz i = 0; i < threads; i++) {
+            workers.emplace_back([&, i] {
+                auto start = i * chunk_size;
+                auto size = i == threads - 1 ? text.size() - start : chunk_size;
+                FindLineStarts(text.data() + start, size, start, chunks[i]);
+            });
+        }
+    }
+
+    usz total = starts.size();
+    for (auto& c : chunks) total += c.size();
+    starts.reserve(total);
+    for (auto& c : chunks) starts.insert(starts.end(), c.begin(), c.end());
+}
+
+template class base::BasicLineIndex<u32>;
+template class base::BasicLineIndex<u64>;
@@ -10,17 +10,19 @@ template <typename Ty>
 concept Numeric = std::integral<Ty> or std::floating_point<Ty>;
 
 template <Numeric Number>
-[[nodiscard]] auto ParseImpl(std::string_view sv) noexcept -> Result<Number> {
+[[nodiscard]] auto ParseImpl(std::string_view sv) noexcept -> Result<Number, CompactError> {
     Number n;
     auto [ptr, ec] = std::from_chars(sv.data(), sv.data() + sv.size(), n);
 
     if (ec != std::errc()) return Error(
+        ec == std::errc::result_out_of_range ? ErrorCode::OutOfRange : ErrorCode::InvalidInput,
         "Failed to parse number from string '{}': {}",
         sv,
-        std::make_error_code(ec).message()
+        ec
     );
 
     if (ptr != sv.data() + sv.size()) return Error(
+        ErrorCode::InvalidInput,
         "Failed to parse integer: Trailing junk at end of string '{}'",
         sv
     );
@@ -29,24 +31,24 @@ template <Numeric Number>
 }
 
 template <>
-auto base::Parse<bool>(std::string_view sv) noexcept -> Result<bool> {
+auto base::Parse<bool>(std::string_view sv) noexcept -> Result<bool, CompactError> {
     if (sv == "true") return true;
     if (sv == "false") return false;
-    return Error("Expected 'true' or 'false', was '{}'", sv);
+    return Error(ErrorCode::InvalidInput, "Expected 'true' or 'false', was '{}'", sv);
 }
 
-template <> auto base::Parse<i8>(std::string_view sv) noexcept -> Result<i8> { return ParseImpl<i8>(sv); }
-template <> auto base::Parse<i16>(std::string_view sv) noexcept -> Result<i16> { return ParseImpl<i16>(sv); }
-template <> auto base::Parse<i32>(std::string_view sv) noexcept -> Result<i32> { return ParseImpl<i32>(sv); }
-template <> auto base::Parse<i64>(std::string_view sv) noexcept -> Result<i64> { return ParseImpl<i64>(sv); }
-template <> auto base::Parse<u8>(std::string_view sv) noexcept -> Result<u8> { return ParseImpl<u8>(sv); }
-template <> auto base::Parse<u16>(std::string_view sv) noexcept -> Result<u16> { return ParseImpl<u16>(sv); }
-template <> auto base::Parse<u32>(std::string_view sv) noexcept -> Result<u32> { return ParseImpl<u32>(sv); }
-template <> auto base::Parse<u64>(std::string_view sv) noexcept -> Result<u64> { return ParseImpl<u64>(sv); }
-template <> auto base::Parse<f32>(std::string_view sv) noexcept -> Result<f32> { return ParseImpl<f32>(sv); }
-template <> auto base::Parse<f64>(std::string_view sv) noexcept -> Result<f64> { return ParseImpl<f64>(sv); }
+template <> auto base::Parse<i8>(std::string_view sv) noexcept -> Result<i8, CompactError> { return ParseImpl<i8>(sv); }
+template <> auto base::Parse<i16>(std::string_view sv) noexcept -> Result<i16, CompactError> { return ParseImpl<i16>(sv); }
+template <> auto base::Parse<i32>(std::string_view sv) noexcept -> Result<i32, CompactError> { return ParseImpl<i32>(sv); }
+template <> auto base::Parse<i64>(std::string_view sv) noexcept -> Result<i64, CompactError> { return ParseImpl<i64>(sv); }
+template <> auto base::Parse<u8>(std::string_view sv) noexcept -> Result<u8, CompactError> { return ParseImpl<u8>(sv); }
+template <> auto base::Parse<u16>(std::string_view sv) noexcept -> Result<u16, CompactError> { return ParseImpl<u16>(sv); }
+template <> auto base::Parse<u32>(std::string_view sv) noexcept -> Result<u32, CompactError> { return ParseImpl<u32>(sv); }
+template <> auto base::Parse<u64>(std::string_view sv) noexcept -> Result<u64, CompactError> { return ParseImpl<u64>(sv); }
+template <> auto base::Parse<f32>(std::string_view sv) noexcept -> Result<f32, CompactError> { return ParseImpl<f32>(sv); }
+template <> auto base::Parse<f64>(std::string_view sv) noexcept -> Result<f64, CompactError> { return ParseImpl<f64>(sv); }
 
 #ifdef LIBBASE_I128_AVAILABLE
-template <> auto base::Parse<i128>(std::string_view sv) noexcept -> Result<i128> { return ParseImpl<i128>(sv); }
-template <> auto base::Parse<u128>(std::string_view sv) noexcept -> Result<u128> { return ParseImpl<u128>(sv); }
+template <> auto base::Parse<i128>(std::string_view sv) noexcept -> Result<i128, CompactError> { return ParseImpl<i128>(sv); }
+template <> auto base::Parse<u128>(std::string_view sv) noexcept -> Result<u128, CompactError> { return ParseImpl<u128>(sv); }
 #endif
@@ -0,0 +1,60 @@
+#include <base/Searcher.hh>
+#include <base/detail/SIMD.hh>
+#include <bit>
+#include <cstring>
+
+using namespace base;
+
+namespace {
+auto FindHorspool(const char* h, usz n, const char* needle, usz m, const u8* skip, usz from) -> usz {
+    const auto last = needle[m - 1];
+    for (usz i = from; i + m <= n;) {
+        auto c = h[i + m - 1];
+        if (c == last and std::memcmp(h + i, needle, m - 1) == 0) return i;
+        i += skip[u8(c)];
+    }
+    return searcher::npos;
+}
+
+#ifdef LIBBASE_SIMD_X86
+/// Look for the first and last character of the needle at 32 positions at
+/// once, and only compare the rest of the needle at positions where both
+/// match.
+LIBBASE_TARGET_AVX2 auto FindAVX2(const char* h, usz n, const char* needle, usz m, const u8* skip) -> usz {
+    const auto first = _mm256_set1_epi8(needle[0]);
+    const auto last = _mm256_set1_epi8(needle[m - 1]);
+    usz i = 0;
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        auto block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+        auto block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + m - 1));
+        auto eq = _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last));
+        for (auto mask = u32(_mm256_movemask_epi8(eq)); mask; mask &= mask - 1) {
+            auto pos = i + usz(std::countr_zero(mask));
+            if (m <= 2 or std::memcmp(h + pos + 1, needle + 1, m - 2) == 0) return pos;
+        }
+    }
+
+    return FindHorspool(h, n, needle, m, skip, i);
+}
+#endif
+} // namespace
+
+auto base::detail::FindSubstring(
+    const char* haystack,
+    usz haystack_size,
+    const char* needle,
+    usz needle_size,
+    const u8* skip
+) noexcept -> usz {
+    if (needle_size == 1) {
+        auto p = static_cast<const char*>(std::memchr(haystack, needle[0], haystack_size));
+        return p ? usz(p - haystack) : searcher::npos;
+    }
+
+#ifdef LIBBASE_SIMD_X86
+    if (haystack_size >= needle_size + 32 and HasAVX2())
+        return FindAVX2(haystack, haystack_size, needle, needle_size, skip);
+#endif
+
+    return FindHorspool(haystack, haystack_size, needle, needle_size, skip, 0);
+}
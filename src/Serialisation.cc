@@ -1,12 +1,214 @@
+#include <base/Assert.hh>
 #include <base/Serialisation.hh>
+#include <base/detail/SIMD.hh>
+#include <algorithm>
 #include <cstring>
 
+using namespace base;
 using namespace base::ser;
 
-template <std::endian E>
-auto Reader<E>::read_bytes_into(void* ptr, usz count) -> Result<> {
+namespace {
+template <typename T>
+void ByteSwapScalar(std::byte* data, usz count) {
+    for (usz i = 0; i < count; i++) {
+        T val;
+        std::memcpy(&val, data + i * sizeof(T), sizeof(T));
+        val = std::byteswap(val);
+        std::memcpy(data + i * sizeof(T), &val, sizeof(T));
+    }
+}
+
+#ifdef LIBBASE_SIMD_X86
+LIBBASE_TARGET_AVX2 auto ByteSwapAVX2(std::byte* data, usz bytes, usz size) -> usz {
+    // Shuffle mask that reverses every group of 'size' bytes; the shuffle
+    // operates on each 16-byte lane separately.
+    alignas(32) char indices[32];
+    for (usz i = 0; i < 32; i++) {
+        auto j = i % 16;
+        indices[i] = char(j / size * size + size - 1 - j % size);
+    }
+
+    auto mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(indices));
+    usz i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), _mm256_shuffle_epi8(v, mask));
+    }
+
+    return i;
+}
+
+/// Decode up to 32 varints that only take up a single byte.
+///
+/// Returns the number of varints decoded.
+LIBBASE_TARGET_AVX2 auto DecodeSingleByteVarintsAVX2(const std::byte* in, u64* out) -> usz {
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    auto multibyte = u32(_mm256_movemask_epi8(v));
+    if (multibyte != 0) {
+        auto n = usz(std::countr_zero(multibyte));
+        for (usz i = 0; i < n; i++) out[i] = u64(in[i]);
+        return n;
+    }
+
+    for (usz i = 0; i < 32; i += 4) {
+        i32 bytes;
+        std::memcpy(&bytes, in + i, 4);
+        auto wide = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), wide);
+    }
+
+    return 32;
+}
+#endif
+
+/// Decode a single varint.
+///
+/// Returns the number of bytes it takes up, or 0 if it is incomplete.
+auto DecodeVarint(const std::byte* p, usz size, u64& val) -> Result<usz, CompactError> {
+    // If the varint ends within the next 8 bytes, extract the 7-bit groups
+    // from all of them at once.
+    if (size >= 8) {
+        u64 w;
+        std::memcpy(&w, p, 8);
+        if constexpr (std::endian::native == std::endian::big) w = std::byteswap(w);
+        if (auto ends = ~w & 0x8080'8080'8080'8080) {
+            auto len = usz(std::countr_zero(ends)) / 8 + 1;
+            if (len < 8) w &= (u64(1) << (8 * len)) - 1;
+            w &= 0x7F7F'7F7F'7F7F'7F7F;
+            w = (w & 0x007F'007F'007F'007F) | (w & 0x7F00'7F00'7F00'7F00) >> 1;
+            w = (w & 0x0000'3FFF'0000'3FFF) | (w & 0x3FFF'0000'3FFF'0000) >> 2;
+            w = (w & 0x0000'0000'0FFF'FFFF) | (w & 0x0FFF'FFFF'0000'0000) >> 4;
+            val = w;
+            return len;
+        }
+    }
+
+    val = 0;
+    for (usz i = 0; i < std::min(size, detail::MaxVarintSize); i++) {
+        auto b = u8(p[i]);
+        if (i == detail::MaxVarintSize - 1 and b > 1) return Error(ErrorCode::OutOfRange, "Varint does not fit in 64 bits");
+        val |= u64(b & 0x7F) << (7 * i);
+        if (not (b & 0x80)) return i + 1;
+    }
+
+    if (size < detail::MaxVarintSize) return 0;
+    return Error(ErrorCode::OutOfRange, "Varint does not fit in 64 bits");
+}
+} // namespace
+
+auto detail::DecodeVarints(ByteSpan in, std::span<u64> out, usz& consumed) -> Result<usz, CompactError> {
+    auto p = in.data();
+    auto end = in.data() + in.size();
+    usz n = 0;
+    while (n < out.size() and p != end) {
+#ifdef LIBBASE_SIMD_X86
+        // Small values are common, so decode runs of single-byte varints
+        // 32 at a time.
+        if (usz(end - p) >= 32 and out.size() - n >= 32 and HasAVX2()) {
+            auto k = DecodeSingleByteVarintsAVX2(p, out.data() + n);
+            p += k;
+            n += k;
+            if (k == 32) continue;
+        }
+#endif
+
+        u64 val;
+        auto len = Try(DecodeVarint(p, usz(end - p), val));
+        if (len == 0) break;
+        out[n++] = val;
+        p += len;
+    }
+
+    consumed = usz(p - in.data());
+    return n;
+}
+
+void detail::ByteSwap(void* data, usz count, usz size) {
+    auto bytes = static_cast<std::byte*>(data);
+    usz done = 0;
+
+#ifdef LIBBASE_SIMD_X86
+    if (size > 1 and count * size >= 32 and HasAVX2()) done = ByteSwapAVX2(bytes, count * size, size) / size;
+#endif
+
+    bytes += done * size;
+    count -= done;
+    switch (size) {
+        case 1: return;
+        case 2: return ByteSwapScalar<u16>(bytes, count);
+        case 4: return ByteSwapScalar<u32>(bytes, count);
+        case 8: return ByteSwapScalar<u64>(bytes, count);
+        default: Unreachable("Cannot byte-swap values of size {}", size);
+    }
+}
+
+template <std::endian E, Encoding Enc>
+Reader<E, Enc>::Reader(SourceFn source, usz chunk_size)
+    : source(std::move(source)), chunk_size(std::max<usz>(chunk_size, 1)) {}
+
+template <std::endian E, Encoding Enc>
+auto Reader<E, Enc>::fill(MutableByteSpan into) -> Result<usz> {
+    usz read = 0;
+    while (read < into.size()) {
+        auto n = Try(source(MutableByteSpan{into.data() + read, into.size() - read}));
+        if (n == 0) break;
+        read += n;
+    }
+    return read;
+}
+
+template <std::endian E, Encoding Enc>
+auto Reader<E, Enc>::refill(usz count) -> Result<> {
+    // Move whatever we haven’t read yet to the start of the buffer.
+    auto buffered = data.size();
+    if (buffered) std::memmove(buffer.data(), data.data(), buffered);
+    if (buffer.size() < chunk_size) buffer.resize(chunk_size);
+
+    // Read at least as much as we need, but don’t wait for more data
+    // than that since the source might not have any yet.
+    while (buffered < count) {
+        // Grow the buffer by at most a chunk at a time; 'count' may come
+        // from corrupt data, so don’t allocate more than the source has.
+        if (buffered == buffer.size()) buffer.resize(std::min(count, buffered + chunk_size));
+        auto n = Try(source(MutableByteSpan{buffer.data() + buffered, buffer.size() - buffered}));
+        if (n == 0) break;
+        buffered += n;
+    }
+
+    data = ByteSpan{buffer.data(), buffered};
+    return {};
+}
+
+template <std::endian E, Encoding Enc>
+auto Reader<E, Enc>::read_bytes_into(void* ptr, usz count) -> Result<void, CompactError> {
+    if (size() < count and source) {
+        // Read large amounts of data directly into the output instead of
+        // going through the buffer.
+        if (count >= chunk_size) {
+            auto out = static_cast<std::byte*>(ptr);
+            auto buffered = size();
+            if (buffered) std::memcpy(out, data.data(), buffered);
+            data = ByteSpan{};
+
+            auto read = buffered + Try(fill(MutableByteSpan{out + buffered, count - buffered}));
+            if (read < count) [[unlikely]] {
+                return Error(
+                    ErrorCode::NotEnoughData,
+                    "Not enough data to read {} bytes ({} bytes left)",
+                    count,
+                    read
+                );
+            }
+
+            return {};
+        }
+
+        Try(refill(count));
+    }
+
     if (size() < count) [[unlikely]] {
         return Error(
+            ErrorCode::NotEnoughData,
             "Not enough data to read {} bytes ({} bytes left)",
             count,
             size()
@@ -18,10 +220,12 @@ auto Reader<E>::read_bytes_into(void* ptr, usz count) -> Result<> {
     return {};
 }
 
-template <std::endian E>
-auto Reader<E>::read_bytes(usz count) -> Result<ByteSpan> {
+template <std::endian E, Encoding Enc>
+auto Reader<E, Enc>::read_bytes(usz count) -> Result<ByteSpan, CompactError> {
+    if (size() < count and source) Try(refill(count));
     if (size() < count) [[unlikely]] {
         return Error(
+            ErrorCode::NotEnoughData,
             "Not enough data to read {} bytes ({} bytes left)",
             count,
             size()
@@ -33,23 +237,180 @@ auto Reader<E>::read_bytes(usz count) -> Result<ByteSpan> {
     return span;
 }
 
-template <std::endian E>
-auto Writer<E>::allocate(u64 bytes) -> MutableByteSpan {
+template <std::endian E, Encoding Enc>
+auto Reader<E, Enc>::read_varint() -> Result<u64, CompactError> {
+    u64 val;
+    Try(read_varints({&val, 1}));
+    return val;
+}
+
+template <std::endian E, Encoding Enc>
+auto Reader<E, Enc>::read_varints(std::span<u64> out) -> Result<void, CompactError> {
+    usz read = 0;
+    for (;;) {
+        usz consumed = 0;
+        read += Try(detail::DecodeVarints(data, out.subspan(read), consumed));
+        data = data.subspan(consumed);
+        if (read == out.size()) return {};
+
+        // The next varint is incomplete; read more data if we can.
+        auto buffered = size();
+        if (source) Try(refill(buffered + 1));
+        if (size() == buffered) [[unlikely]] {
+            return Error(
+                ErrorCode::NotEnoughData,
+                "Not enough data to read varint ({} bytes left)",
+                size()
+            );
+        }
+    }
+}
+
+template <std::endian E, Encoding Enc>
+Writer<E, Enc>::Writer(SinkFn sink, usz chunk_size)
+    : data(buffer), sink(std::move(sink)), chunk_size(std::max<usz>(chunk_size, 1)), mode(Mode::Sink) {
+    buffer.reserve(this->chunk_size);
+}
+
+template <std::endian E, Encoding Enc>
+Writer<E, Enc>::~Writer() {
+    flush_buffer();
+}
+
+template <std::endian E, Encoding Enc>
+auto Writer<E, Enc>::flush() -> Result<> {
+    flush_buffer();
+    return status;
+}
+
+template <std::endian E, Encoding Enc>
+void Writer<E, Enc>::flush_buffer() {
+    if (mode != Mode::Sink or data.empty()) return;
+
+    // Once writing has failed, drop everything else so we don’t keep
+    // accumulating data that will never be written.
+    if (status) status = sink(data);
+    data.clear();
+}
+
+template <std::endian E, Encoding Enc>
+void Writer<E, Enc>::overflow(usz count) {
+    if (status) status = Error(
+        "Not enough space to write {} bytes ({} bytes left)",
+        count,
+        out.size()
+    );
+
+    // Everything after this doesn’t fit either.
+    out = MutableByteSpan{};
+}
+
+template <std::endian E, Encoding Enc>
+auto Writer<E, Enc>::allocate(u64 bytes) -> MutableByteSpan {
+    total += bytes;
+    if (mode == Mode::Span and bytes <= out.size()) {
+        MutableByteSpan span{out.data(), bytes};
+        out = out.subspan(bytes);
+        return span;
+    }
+
+    // If there is nowhere to put the data, give the caller some scratch
+    // memory to write to.
+    if (mode == Mode::Span or mode == Mode::Count) {
+        if (mode == Mode::Span) overflow(bytes);
+        buffer.resize(bytes);
+        return {buffer.data(), bytes};
+    }
+
+    if (mode == Mode::Sink and data.size() + bytes > chunk_size) flush_buffer();
     auto old_size = data.size();
     data.resize(old_size + bytes);
     return {data.data() + old_size, bytes};
 }
 
-template <std::endian E>
-void Writer<E>::append_bytes(const void* ptr, usz count) {
+template <std::endian E, Encoding Enc>
+void Writer<E, Enc>::append_bytes(const void* ptr, usz count) {
     auto* p = static_cast<const std::byte*>(ptr);
-    data.insert(data.end(), p, p + count);
+    total += count;
+    switch (mode) {
+        case Mode::Vector:
+            data.insert(data.end(), p, p + count);
+            return;
+
+        case Mode::Sink:
+            if (data.size() + count > chunk_size) {
+                flush_buffer();
+
+                // Pass large amounts of data to the sink directly instead
+                // of copying them into the buffer.
+                if (count >= chunk_size) {
+                    if (status) status = sink(ByteSpan{p, count});
+                    return;
+                }
+            }
+
+            data.insert(data.end(), p, p + count);
+            return;
+
+        case Mode::Span:
+            if (count > out.size()) return overflow(count);
+            if (count) std::memcpy(out.data(), p, count);
+            out = out.subspan(count);
+            return;
+
+        case Mode::Count:
+            return;
+    }
+
+    Unreachable();
+}
+
+auto SpanSink::write(ByteSpan bytes) -> Result<> {
+    if (bytes.size() > buffer.size() - pos) [[unlikely]] {
+        return Error(
+            "Not enough space to write {} bytes ({} bytes left)",
+            bytes.size(),
+            buffer.size() - pos
+        );
+    }
+
+    if (not bytes.empty()) std::memcpy(buffer.data() + pos, bytes.data(), bytes.size());
+    pos += bytes.size();
+    return {};
+}
+
+auto detail::OffsetTable::entry(usz i) const -> Result<ByteSpan> {
+    if (i >= size()) [[unlikely]] {
+        return Error(
+            "Index {} is out of bounds for indexed range of size {}",
+            i,
+            size()
+        );
+    }
+
+    auto start = offset(i);
+    auto end = offset(i + 1);
+    if (start > end or end > data.size()) [[unlikely]] {
+        return Error(
+            "Invalid offsets for element {}: [{}, {}) with {} bytes of data",
+            i,
+            start,
+            end,
+            data.size()
+        );
+    }
+
+    return data.subspan(usz(start), usz(end - start));
 }
 
 namespace base::ser {
-template class Reader<std::endian::little>;
-template class Reader<std::endian::big>;
+template class Reader<std::endian::little, Encoding::Fixed>;
+template class Reader<std::endian::big, Encoding::Fixed>;
+template class Reader<std::endian::little, Encoding::Varint>;
+template class Reader<std::endian::big, Encoding::Varint>;
 
-template class Writer<std::endian::little>;
-template class Writer<std::endian::big>;
+template class Writer<std::endian::little, Encoding::Fixed>;
+template class Writer<std::endian::big, Encoding::Fixed>;
+template class Writer<std::endian::little, Encoding::Varint>;
+template class Writer<std::endian::big, Encoding::Varint>;
 }
@@ -0,0 +1,20 @@
+#include <base/FS.hh>
+#include <base/StringBuilder.hh>
+
+using namespace base;
+
+template <typename CharType>
+auto BasicStringBuilder<CharType>::write_to(fs::File& file) const -> Result<> {
+    std::vector<ByteSpan> data;
+    data.reserve(chunk_list.size());
+    for (auto& c : chunk_list) {
+        if (c.size == 0) continue;
+        data.emplace_back(reinterpret_cast<const char*>(c.data.get()), c.size * sizeof(CharType));
+    }
+    return file.writev(data);
+}
+
+template class base::BasicStringBuilder<char>;
+template class base::BasicStringBuilder<char8_t>;
+template class base::BasicStringBuilder<char16_t>;
+template class base::BasicStringBuilder<char32_t>;
@@ -1,5 +1,6 @@
 #include <base/Base.hh>
 #include <base/Text.hh>
+#include <array>
 #include <source_location>
 #include <stdexcept>
 #include <base/StringUtils.hh>
@@ -8,40 +9,116 @@
 #   include <unistd.h>
 #endif
 
+using namespace base;
+
+namespace {
+/// Characters that always need to be escaped.
+constexpr auto AlwaysEscaped = ~CharSet::FromPredicate(text::IsPrint) | CharSet{"\\"};
+
+/// Escape sequences for all characters; empty for those that are printed as-is.
+struct EscapeTable {
+    std::array<std::array<char, 4>, 256> seqs{};
+    std::array<u8, 256> sizes{};
+
+    consteval EscapeTable() {
+        constexpr std::string_view Hex = "0123456789abcdef";
+        for (u32 c = 0; c < 256; c++) {
+            if (not AlwaysEscaped.contains(c)) continue;
+            char seq[]{'\\', 'x', Hex[c >> 4], Hex[c & 15]};
+            set(c, {seq, 4});
+        }
+
+        set('\n', "\\n");
+        set('\r', "\\r");
+        set('\t', "\\t");
+        set('\v', "\\v");
+        set('\f', "\\f");
+        set('\a', "\\a");
+        set('\b', "\\b");
+        set('\\', "\\\\");
+        set('\0', "\\0");
+        set('\033', "\\e");
+    }
+
+    constexpr void set(u32 c, std::string_view seq) {
+        std::copy(seq.begin(), seq.end(), seqs[c].begin());
+        sizes[c] = u8(seq.size());
+    }
+
+    [[nodiscard]] constexpr auto operator[](char c) const -> std::string_view {
+        return {seqs[u8(c)].data(), sizes[u8(c)]};
+    }
+};
+
+constexpr EscapeTable Escapes;
+
+template <typename Buffer>
+void EscapeImpl(Buffer& out, str s, bool escape_double_quotes, bool escape_per_cent_signs) {
+    static constexpr CharSet Sets[4]{
+        AlwaysEscaped,
+        AlwaysEscaped | CharSet{"\""},
+        AlwaysEscaped | CharSet{"%"},
+        AlwaysEscaped | CharSet{"\"%"},
+    };
+
+    // Copy runs of characters that don’t need escaping all at once.
+    const auto& set = Sets[escape_double_quotes | escape_per_cent_signs << 1];
+    while (not s.empty()) {
+        out += s.take_until_any(set);
+        if (s.empty()) break;
+        switch (auto c = s.take()[0]) {
+            case '"': out += "\\\""; break;
+            case '%': out += "%%"; break;
+            default: out += Escapes[c];
+        }
+    }
+}
+
+template <typename Buffer>
+void IndentImpl(Buffer& out, str s, u32 width) {
+    std::string id(width, ' ');
+    bool first = true;
+    for (auto l : s.lines()) {
+        if (not first) out += "\n";
+        else first = false;
+        if (l.empty()) continue;
+        out += id;
+        out += l;
+    }
+}
+} // namespace
+
 auto base::utils::Escape(
     str s,
     bool escape_double_quotes,
     bool escape_per_cent_signs
 ) -> std::string {
     std::string out;
-    for (auto c : s) {
-        switch (c) {
-            case '\n': out += "\\n"; break;
-            case '\r': out += "\\r"; break;
-            case '\t': out += "\\t"; break;
-            case '\v': out += "\\v"; break;
-            case '\f': out += "\\f"; break;
-            case '\a': out += "\\a"; break;
-            case '\b': out += "\\b"; break;
-            case '\\': out += "\\\\"; break;
-            case '\0': out += "\\0"; break;
-            case '\033': out += "\\e"; break;
-            case '"':
-                if (escape_double_quotes) out += "\\\"";
-                else out += c;
-                break;
-            case '%':
-                if (escape_per_cent_signs) out += "%%";
-                else out += c;
-                break;
-            default:
-                if (text::IsPrint(c)) out += c;
-                else out += std::format("\\x{:02x}", static_cast<u8>(c));
-        }
-    }
+    out.reserve(s.size());
+    EscapeImpl(out, s, escape_double_quotes, escape_per_cent_signs);
     return out;
 }
 
+void base::utils::EscapeInto(
+    std::string& out,
+    str s,
+    bool escape_double_quotes,
+    bool escape_per_cent_signs
+) {
+    out.reserve(out.size() + s.size());
+    EscapeImpl(out, s, escape_double_quotes, escape_per_cent_signs);
+}
+
+void base::utils::EscapeInto(
+    StringBuilder& out,
+    str s,
+    bool escape_double_quotes,
+    bool escape_per_cent_signs
+) {
+    out.reserve_hint(s.size());
+    EscapeImpl(out, s, escape_double_quotes, escape_per_cent_signs);
+}
+
 auto base::utils::HumanReadable(u64 value) -> std::string {
     if (value < u64(1) << 10) return std::format("{}", value);
     if (value < u64(1) << 20) return std::format("{}K", value / (u64(1) << 10));
@@ -59,18 +136,14 @@ auto base::utils::HumanReadable(i64 value) -> std::string {
 
 auto base::utils::Indent(str s, u32 width) -> std::string {
     std::string out;
-    std::string id(width, ' ');
-    bool first = true;
-    for (auto l : s.lines()) {
-        if (not first) out += "\n";
-        else first = false;
-        if (l.empty()) continue;
-        out += id;
-        out += l;
-    }
+    IndentImpl(out, s, width);
     return out;
 }
 
+void base::utils::IndentInto(StringBuilder& out, str s, u32 width) {
+    IndentImpl(out, s, width);
+}
+
 static bool StreamSupportsColours([[maybe_unused]] int fd) {
 #ifdef LIBBASE_USE_LIBASSERT
     // If libassert is available, use it to figure this out.
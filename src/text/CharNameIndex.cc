@@ -0,0 +1,160 @@
+#include <base/CharNameIndex.hh>
+#include <base/Text.hh>
+#include <algorithm>
+#include <functional>
+#include <span>
+
+#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
+#    include <unicode/uchar.h>
+#endif
+
+using namespace base;
+using namespace base::text;
+
+namespace {
+constexpr usz TrigramSize = 3;
+
+[[nodiscard]] constexpr auto Trigram(std::string_view s, usz i) -> u32 {
+    return u32(u8(s[i])) << 16 | u32(u8(s[i + 1])) << 8 | u32(u8(s[i + 2]));
+}
+} // namespace
+
+#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
+auto CharNameIndex::Build(c32 from, c32 to) -> CharNameIndex {
+    CharNameIndex idx;
+    auto Enum = []( // clang-format off
+        void* context,
+        UChar32 code,
+        UCharNameChoice,
+        const char* name,
+        int32_t length
+    ) -> UBool {
+        auto& idx = *static_cast<CharNameIndex*>(context);
+        idx.chars.push_back(char32_t(code));
+        idx.names.append(name, usz(length));
+        idx.name_offsets.push_back(u32(idx.names.size()));
+        return true;
+    }; // clang-format on
+
+    UErrorCode ec{U_ZERO_ERROR};
+    u_enumCharNames(UChar32(from), UChar32(to) + 1, Enum, &idx, U_UNICODE_CHAR_NAME, &ec);
+
+    // Collect every (trigram, name) pair; sorting them groups the names
+    // by trigram, and since the names are added in order, each group
+    // is already sorted.
+    std::vector<u64> pairs;
+    std::vector<u32> name_trigrams;
+    for (usz i = 0; i < idx.chars.size(); i++) {
+        auto name = idx.name_at(i);
+        if (name.size() < TrigramSize) continue;
+
+        name_trigrams.clear();
+        for (usz j = 0; j + TrigramSize <= name.size(); j++) name_trigrams.push_back(Trigram(name, j));
+        rgs::sort(name_trigrams);
+        auto [first, last] = rgs::unique(name_trigrams);
+        name_trigrams.erase(first, last);
+        for (auto t : name_trigrams) pairs.push_back(u64(t) << 32 | i);
+    }
+
+    rgs::sort(pairs);
+    idx.postings.reserve(pairs.size());
+    for (auto p : pairs) {
+        auto t = u32(p >> 32);
+        if (idx.trigrams.empty() or idx.trigrams.back() != t) {
+            if (not idx.trigrams.empty()) idx.posting_offsets.push_back(u32(idx.postings.size()));
+            idx.trigrams.push_back(t);
+        }
+        idx.postings.push_back(u32(p));
+    }
+
+    if (not idx.trigrams.empty()) idx.posting_offsets.push_back(u32(idx.postings.size()));
+    return idx;
+}
+
+auto CharNameIndex::Get() -> const CharNameIndex& {
+    static const CharNameIndex index = Build();
+    return index;
+}
+#endif
+
+auto CharNameIndex::check() const -> Result<> {
+    if (name_offsets.size() != chars.size() + 1) return Error(
+        "Name index has {} characters but {} name offsets",
+        chars.size(),
+        name_offsets.size()
+    );
+
+    if (posting_offsets.size() != trigrams.size() + 1) return Error(
+        "Name index has {} trigrams but {} posting offsets",
+        trigrams.size(),
+        posting_offsets.size()
+    );
+
+    if (name_offsets.front() != 0 or name_offsets.back() != names.size() or not rgs::is_sorted(name_offsets))
+        return Error("Name offsets are out of bounds");
+
+    if (posting_offsets.front() != 0 or posting_offsets.back() != postings.size() or not rgs::is_sorted(posting_offsets))
+        return Error("Posting offsets are out of bounds");
+
+    if (rgs::adjacent_find(chars, std::greater_equal{}) != chars.end())
+        return Error("Characters in name index are not sorted");
+
+    if (rgs::adjacent_find(trigrams, std::greater_equal{}) != trigrams.end())
+        return Error("Trigrams in name index are not sorted");
+
+    if (rgs::any_of(postings, [&](u32 p) { return p >= chars.size(); }))
+        return Error("Posting is out of bounds");
+
+    return {};
+}
+
+auto CharNameIndex::find(std::string_view query) const -> std::vector<c32> {
+    // All character names are upper case.
+    std::string q{query};
+    for (auto& c : q)
+        if (text::IsLower(c))
+            c = char(c - 'a' + 'A');
+
+    std::vector<c32> found;
+    if (q.size() < TrigramSize) {
+        for (usz i = 0; i < chars.size(); i++)
+            if (name_at(i).contains(q))
+                found.push_back(chars[i]);
+        return found;
+    }
+
+    // Every name that contains the query contains all of its trigrams, so
+    // we only need to check the names that contain the rarest one.
+    std::span<const u32> candidates;
+    for (usz j = 0; j + TrigramSize <= q.size(); j++) {
+        auto it = rgs::lower_bound(trigrams, Trigram(q, j));
+        if (it == trigrams.end() or *it != Trigram(q, j)) return {};
+        auto t = usz(it - trigrams.begin());
+        std::span<const u32> p{postings.data() + posting_offsets[t], posting_offsets[t + 1] - posting_offsets[t]};
+        if (candidates.empty() or p.size() < candidates.size()) candidates = p;
+    }
+
+    for (auto i : candidates)
+        if (name_at(i).contains(q))
+            found.push_back(chars[i]);
+    return found;
+}
+
+auto CharNameIndex::find_if(
+    std::function<bool(c32, std::string_view)> filter,
+    c32 from,
+    c32 to
+) const -> std::vector<c32> {
+    std::vector<c32> found;
+    auto start = usz(rgs::lower_bound(chars, from.value) - chars.begin());
+    for (usz i = start; i < chars.size() and chars[i] <= to.value; i++)
+        if (filter(chars[i], name_at(i)))
+            found.push_back(chars[i]);
+    return found;
+}
+
+auto CharNameIndex::name(c32 c) const -> std::optional<std::string_view> {
+    auto it = rgs::lower_bound(chars, c.value);
+    if (it == chars.end() or *it != c.value) return std::nullopt;
+    return name_at(usz(it - chars.begin()));
+}
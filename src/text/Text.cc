@@ -1,16 +1,26 @@
 #include <base/Base.hh>
+#include <base/CharNameIndex.hh>
 #include <base/Text.hh>
-
-// LLVM has a pretty comprehensive function for determining the column width
-// of a character, so use if if available.
-#ifdef LIBBASE_ENABLE_LLVM_BINDINGS_UNICODE
-#    include <llvm/Support/Unicode.h>
-#endif
+#include <base/detail/SIMD.hh>
+#include <base/detail/UTF.hh>
 
 using namespace base;
 using namespace base::text;
 
-static void StripANSIEscapes(auto s, auto callback) {
+/// ====================================================================
+///  Column Width
+/// ====================================================================
+namespace {
+constexpr CharSet Printable = CharSet::FromRange(' ', '~');
+constexpr CharSet NonASCII = CharSet::FromRange('\x80', '\xff');
+
+[[nodiscard]] auto Width(char32_t c) -> usz {
+    if (c == U'\t') return 4;
+    if (c > 0x10'FFFF) return 1;
+    return detail::LookupProperty<2>(detail::WidthStage1, detail::WidthStage2, c);
+}
+
+void StripANSIEscapes(auto s, auto callback) {
     do {
         auto text = s.take_until('\033');
         if (not text.empty()) std::invoke(callback, text);
@@ -18,44 +28,40 @@ static void StripANSIEscapes(auto s, auto callback) {
         s.drop();
     } while (not s.empty());
 }
+} // namespace
 
-// Define ColumnWidth(UTF-8) to use the LLVM bindings if possible. If they aren’t available,
-// invoke the UTF-32 version instead.
-#if defined(LIBBASE_ENABLE_UNICODE_SUPPORT) || defined(LIBBASE_ENABLE_LLVM_BINDINGS_UNICODE)
 usz text::ColumnWidth(std::string_view text) {
-#   ifdef LIBBASE_ENABLE_LLVM_BINDINGS_UNICODE
     usz wd = 0;
-    StripANSIEscapes(str(text), [&](std::string_view part) {
-        int res = llvm::sys::unicode::columnWidthUTF8(part);
-        if (res > 0) wd += usz(res);
+    StripANSIEscapes(str(text), [&](str s) {
+        while (not s.empty()) {
+            // Most text is ASCII, so measure runs of ASCII characters in bulk.
+            auto ascii = s.take_until_any(NonASCII);
+            wd += ascii.count_any(Printable) + 4 * ascii.count('\t');
+
+            // Decode everything else until we get back to ASCII.
+            auto it = s.data();
+            auto end = s.data() + s.size();
+            while (it != end and u8(*it) >= 0x80) wd += Width(detail::DecodeUTF8(it, end));
+            s = str{it, usz(end - it)};
+        }
     });
     return wd;
-#   else
-    return ColumnWidth(ToUTF32(text));
-#   endif
 }
-#endif
 
-// Conversely, the 32-bit version delegates to the LLVM version if possible and provides
-// the naive implementation otherwise.
 usz text::ColumnWidth(std::u32string_view text) {
-#if defined(LIBBASE_ENABLE_UNICODE_SUPPORT) && defined(LIBBASE_ENABLE_LLVM_BINDINGS_UNICODE)
-    return ColumnWidth(ToUTF8(text));
-#else
     usz wd = 0;
     StripANSIEscapes(str32(text), [&](std::u32string_view part) {
-        for (auto c : part) {
-            if (char32_t(char(c)) == c and IsCntrl(char(c))) continue;
-            if (c == '\t') wd += 4;
-            else wd++;
-        }
+        for (auto c : part) wd += Width(c);
     });
     return wd;
-#endif
 }
 
 #ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
+#    include <base/Threading.hh>
 #    include <functional>
+#    include <thread>
+#    include <unicode/bytestream.h>
+#    include <unicode/normalizer2.h>
 #    include <unicode/translit.h>
 #    include <unicode/uchar.h>
 #    include <unicode/unistr.h>
@@ -106,52 +112,6 @@ template <>
 /// ====================================================================
 ///  C32
 /// ====================================================================
-auto c32::category() const noexcept -> CharCategory {
-    // This conversion is actually a no-op. The values chosen
-    // by us are the same ones that ICU uses, and I don’t think
-    // they’re going to change.
-    switch (UCharCategory(u_charType(UChar32(value)))) {
-        default: return CharCategory::Unassigned;
-        case U_UPPERCASE_LETTER: return CharCategory::UppercaseLetter;
-        case U_LOWERCASE_LETTER: return CharCategory::LowercaseLetter;
-        case U_TITLECASE_LETTER: return CharCategory::TitlecaseLetter;
-        case U_MODIFIER_LETTER: return CharCategory::ModifierLetter;
-        case U_OTHER_LETTER: return CharCategory::OtherLetter;
-        case U_NON_SPACING_MARK: return CharCategory::NonSpacingMark;
-        case U_ENCLOSING_MARK: return CharCategory::EnclosingMark;
-        case U_COMBINING_SPACING_MARK: return CharCategory::CombiningSpacingMark;
-        case U_DECIMAL_DIGIT_NUMBER: return CharCategory::DecimalDigitNumber;
-        case U_LETTER_NUMBER: return CharCategory::LetterNumber;
-        case U_OTHER_NUMBER: return CharCategory::OtherNumber;
-        case U_SPACE_SEPARATOR: return CharCategory::SpaceSeparator;
-        case U_LINE_SEPARATOR: return CharCategory::LineSeparator;
-        case U_PARAGRAPH_SEPARATOR: return CharCategory::ParagraphSeparator;
-        case U_CONTROL_CHAR: return CharCategory::ControlChar;
-        case U_FORMAT_CHAR: return CharCategory::FormatChar;
-        case U_PRIVATE_USE_CHAR: return CharCategory::PrivateUseChar;
-        case U_SURROGATE: return CharCategory::Surrogate;
-        case U_DASH_PUNCTUATION: return CharCategory::DashPunctuation;
-        case U_START_PUNCTUATION: return CharCategory::StartPunctuation;
-        case U_END_PUNCTUATION: return CharCategory::EndPunctuation;
-        case U_CONNECTOR_PUNCTUATION: return CharCategory::ConnectorPunctuation;
-        case U_OTHER_PUNCTUATION: return CharCategory::OtherPunctuation;
-        case U_MATH_SYMBOL: return CharCategory::MathSymbol;
-        case U_CURRENCY_SYMBOL: return CharCategory::CurrencySymbol;
-        case U_MODIFIER_SYMBOL: return CharCategory::ModifierSymbol;
-        case U_OTHER_SYMBOL: return CharCategory::OtherSymbol;
-        case U_INITIAL_PUNCTUATION: return CharCategory::InitialPunctuation;
-        case U_FINAL_PUNCTUATION: return CharCategory::FinalPunctuation;
-    }
-}
-
-bool c32::is_xid_continue() const noexcept {
-    return u_hasBinaryProperty(UChar32(value), UCHAR_XID_CONTINUE);
-}
-
-bool c32::is_xid_start() const noexcept {
-    return u_hasBinaryProperty(UChar32(value), UCHAR_XID_START);
-}
-
 auto c32::name() const noexcept -> Result<std::string> {
     UErrorCode ec{U_ZERO_ERROR};
     std::array<char, 1'024> char_name{};
@@ -179,34 +139,6 @@ auto c32::name() const noexcept -> Result<std::string> {
     return std::string{char_name.data(), usz(len)};
 }
 
-auto c32::swap_case() const noexcept -> c32 {
-    auto cat = category();
-    if (cat == CharCategory::UppercaseLetter) return to_lower();
-    if (cat == CharCategory::LowercaseLetter) return to_upper();
-    return *this;
-}
-
-auto c32::to_lower() const noexcept -> c32 {
-    return char32_t(u_tolower(UChar32(value)));
-}
-
-auto c32::to_upper() const noexcept -> c32 {
-    return char32_t(u_toupper(UChar32(value)));
-}
-
-auto c32::width() const noexcept -> unsigned {
-    auto val = u_getIntPropertyValue(UChar32(value), UCHAR_EAST_ASIAN_WIDTH);
-    switch (UEastAsianWidth(val)) {
-        default:
-            return 1;
-
-        // Ambiguous characters are not treated as wide as per Unicode Standard Annex #11.
-        case U_EA_FULLWIDTH:
-        case U_EA_WIDE:
-            return 2;
-    }
-}
-
 /// ====================================================================
 ///  Miscellaneous
 /// ====================================================================
@@ -215,70 +147,32 @@ auto text::FindCharsByName(
     c32 from,
     c32 to
 ) -> std::vector<c32> {
-    UErrorCode ec{U_ZERO_ERROR};
-    std::vector<c32> chars;
-    struct Ctx {
-        std::vector<c32>& chars; // Not the actual vector to support NRVO.
-        decltype(filter) f;
-    } ctx{chars, std::move(filter)};
-
-    auto Enum = []( // clang-format off
-        void* context,
-        UChar32 code,
-        UCharNameChoice,
-        const char* name,
-        int32_t length
-    ) -> UBool {
-        auto& ctx = *static_cast<Ctx*>(context);
-        if (ctx.f(c32(code), std::string_view{name, usz(length)}))
-            ctx.chars.push_back(c32(code));
-        return true;
-    }; // clang-format on
-
-    u_enumCharNames(UChar32(from), UChar32(to), Enum, &ctx, U_UNICODE_CHAR_NAME, &ec);
-    return chars;
+    // 'to' is exclusive here, but inclusive in the index.
+    if (from >= to) return {};
+    return CharNameIndex::Get().find_if(std::move(filter), from, c32(to.value - 1));
 }
 
 /// ====================================================================
-///  Transliteration and Normalisation
+///  Transliteration
 /// ====================================================================
 namespace {
-[[nodiscard]] auto GetTransliterator(NormalisationForm nf) -> Transliterator& {
-    // Cache transliterators so we can call Normalise() repeatedly w/o
-    // creating a new one every time.
-    thread_local std::unordered_map<NormalisationForm, Transliterator> cache;
-    auto it = cache.find(nf);
-    if (it != cache.end()) return it->second;
-
-    // This transliterator doesn’t exist yet (for this thread); create a new one.
-    auto form = [&] -> std::string_view {
-        switch (nf) {
-            case NormalisationForm::NFC: return "NFC";
-            case NormalisationForm::NFD: return "NFD";
-            case NormalisationForm::NFKC: return "NFKC";
-            case NormalisationForm::NFKD: return "NFKD";
-            default: return "Any-Normalization";
-        }
-    }();
-
-    // If we fail to create a transliterator for any of the normalisation forms,
-    // then something is seriously wrong with our ICU installation.
-    auto t = Transliterator::Create(form);
-    Assert(t.has_value(), "Failed to create transliterator for normalisation form {}", form);
+[[nodiscard]] auto CreateICUTransliterator(std::string_view rules) -> Result<icu::Transliterator*> {
+    UErrorCode ec{U_ZERO_ERROR};
+    auto trans = icu::Transliterator::createInstance(
+        UStr(rules),
+        UTRANS_FORWARD,
+        ec
+    );
 
-    // And cache it.
-    cache.emplace(nf, std::move(t.value()));
-    return cache.at(nf);
-}
+    // If an NFC/NFD transliterator is not available, then that is a pretty
+    // serious problem with the ICU installation; that likely means there is
+    // nothing else we can do here, so just give up.
+    if (U_FAILURE(ec)) return Error(
+        "Failed to create transliterator: {}\n",
+        u_errorName(ec)
+    );
 
-template <typename CharTy>
-[[nodiscard]] auto NormaliseImpl(
-    std::basic_string_view<CharTy> str,
-    NormalisationForm form
-) -> std::basic_string<CharTy> {
-    if (form == NormalisationForm::None) return std::basic_string<CharTy>{str};
-    Transliterator& trans = GetTransliterator(form);
-    return trans(str);
+    return trans;
 }
 
 template <typename Char>
@@ -293,22 +187,7 @@ auto Transliterate(
 } // namespace
 
 auto Transliterator::Create(std::string_view rules) -> Result<Transliterator> {
-    UErrorCode ec{U_ZERO_ERROR};
-    auto trans = icu::Transliterator::createInstance(
-        UStr(rules),
-        UTRANS_FORWARD,
-        ec
-    );
-
-    // If an NFC/NFD transliterator is not available, then that is a pretty
-    // serious problem with the ICU installation; that likely means there is
-    // nothing else we can do here, so just give up.
-    if (U_FAILURE(ec)) return Error(
-        "Failed to create transliterator: {}\n",
-        u_errorName(ec)
-    );
-
-    return Transliterator(trans);
+    return Transliterator(Try(CreateICUTransliterator(rules)));
 }
 
 auto Transliterator::icu_ptr() const { return static_cast<icu::Transliterator*>(impl); }
@@ -326,61 +205,318 @@ auto Transliterator::operator()(std::u32string_view str) const -> std::u32string
     return Transliterate(icu_ptr(), str);
 }
 
+struct TransliteratorPool::Impl {
+    using Ptr = std::unique_ptr<icu::Transliterator>;
+
+    /// The transliterator that all others are cloned from; this one
+    /// is never used directly.
+    Ptr prototype;
+
+    /// Transliterators that are not currently in use.
+    ThreadSafe<std::vector<Ptr>> idle;
+
+    /// Take a transliterator from the pool, or create one if there are
+    /// none left.
+    auto acquire() -> Ptr {
+        auto t = idle.with([&](std::vector<Ptr>& list) {
+            if (list.empty()) return Ptr();
+            auto cached = std::move(list.back());
+            list.pop_back();
+            return cached;
+        });
+
+        // Cloning is expensive, so don’t hold the lock while doing it.
+        if (not t) t = Ptr(prototype->clone());
+        return t;
+    }
+
+    /// Return a transliterator to the pool.
+    void release(Ptr t) {
+        idle.with([&](std::vector<Ptr>& list) { list.push_back(std::move(t)); });
+    }
+
+    template <typename Char>
+    auto batch(
+        std::span<const std::basic_string_view<Char>> strings,
+        usz threads
+    ) -> std::vector<std::basic_string<Char>> {
+        std::vector<std::basic_string<Char>> out(strings.size());
+        auto Work = [&](usz start, usz end) {
+            auto t = acquire();
+            LIBBASE_DEFER { release(std::move(t)); };
+            for (usz i = start; i < end; i++) out[i] = Transliterate(t.get(), strings[i]);
+        };
+
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, strings.size());
+        if (threads <= 1) {
+            Work(0, strings.size());
+            return out;
+        }
+
+        const usz chunk_size = strings.size() / threads;
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for (usz i = 0; i < threads; i++) {
+            auto start = i * chunk_size;
+            auto end = i == threads - 1 ? strings.size() : start + chunk_size;
+            workers.emplace_back(Work, start, end);
+        }
+
+        workers.clear();
+        return out;
+    }
+
+    template <typename Char>
+    auto transliterate(std::basic_string_view<Char> str) -> std::basic_string<Char> {
+        auto t = acquire();
+        LIBBASE_DEFER { release(std::move(t)); };
+        return Transliterate(t.get(), str);
+    }
+};
+
+LIBBASE_DEFINE_HIDDEN_IMPL(TransliteratorPool)
+
+auto TransliteratorPool::Create(std::string_view rules) -> Result<TransliteratorPool> {
+    TransliteratorPool pool;
+    pool.impl = std::make_unique<Impl>();
+    pool.impl->prototype.reset(Try(CreateICUTransliterator(rules)));
+    return pool;
+}
+
+auto TransliteratorPool::batch(
+    std::span<const std::string_view> strings,
+    usz threads
+) const -> std::vector<std::string> {
+    return impl->batch(strings, threads);
+}
+
+auto TransliteratorPool::batch(
+    std::span<const std::u32string_view> strings,
+    usz threads
+) const -> std::vector<std::u32string> {
+    return impl->batch(strings, threads);
+}
+
+auto TransliteratorPool::operator()(std::string_view str) const -> std::string {
+    return impl->transliterate(str);
+}
+
+auto TransliteratorPool::operator()(std::u16string_view str) const -> std::u16string {
+    return impl->transliterate(str);
+}
+
+auto TransliteratorPool::operator()(std::u32string_view str) const -> std::u32string {
+    return impl->transliterate(str);
+}
+
+/// ====================================================================
+///  Normalisation
+/// ====================================================================
+namespace {
+[[nodiscard]] auto GetNormaliser(NormalisationForm nf) -> const icu::Normalizer2* {
+    UErrorCode ec{U_ZERO_ERROR};
+    auto norm = [&] -> const icu::Normalizer2* {
+        switch (nf) {
+            case NormalisationForm::None: return nullptr;
+            case NormalisationForm::NFC: return icu::Normalizer2::getNFCInstance(ec);
+            case NormalisationForm::NFD: return icu::Normalizer2::getNFDInstance(ec);
+            case NormalisationForm::NFKC: return icu::Normalizer2::getNFKCInstance(ec);
+            case NormalisationForm::NFKD: return icu::Normalizer2::getNFKDInstance(ec);
+        }
+        Unreachable();
+    }();
+
+    // The normalisers are part of ICU’s data; if they’re not available,
+    // then something is seriously wrong with our ICU installation.
+    Assert(U_SUCCESS(ec), "Failed to get normaliser: {}", u_errorName(ec));
+    return norm;
+}
+
+/// Get the number of characters at the start of a string that are
+/// unaffected by normalisation because they are ASCII.
+template <typename CharTy>
+[[nodiscard]] auto UnaffectedASCIIPrefix(std::basic_string_view<CharTy> str) -> usz {
+    // ASCII text is in every normalisation form, but the last ASCII
+    // character may combine with whatever comes after it.
+    auto ascii = detail::AsciiPrefix(str);
+    return ascii == str.size() or ascii == 0 ? ascii : ascii - 1;
+}
+
+template <typename CharTy>
+[[nodiscard]] bool IsNormalisedImpl(
+    std::basic_string_view<CharTy> str,
+    NormalisationForm form
+) {
+    if (form == NormalisationForm::None) return true;
+    str.remove_prefix(UnaffectedASCIIPrefix(str));
+    if (str.empty()) return true;
+
+    UErrorCode ec{U_ZERO_ERROR};
+    auto norm = GetNormaliser(form);
+    if constexpr (sizeof(CharTy) == 1) {
+        return norm->isNormalizedUTF8(icu::StringPiece(str.data(), i32(str.size())), ec);
+    } else {
+        return norm->isNormalized(::UStr(str), ec);
+    }
+}
+
+template <typename CharTy>
+void NormaliseIntoImpl(
+    std::basic_string<CharTy>& out,
+    std::basic_string_view<CharTy> str,
+    NormalisationForm form
+) {
+    // Copy the part of the string that can’t change as-is.
+    auto prefix = form == NormalisationForm::None ? str.size() : UnaffectedASCIIPrefix(str);
+    out += str.substr(0, prefix);
+    str.remove_prefix(prefix);
+    if (str.empty()) return;
+
+    // ICU already skips over text that passes the quick check and copies
+    // it to the output, so we don’t need to check the rest ourselves.
+    UErrorCode ec{U_ZERO_ERROR};
+    auto norm = GetNormaliser(form);
+    if constexpr (sizeof(CharTy) == 1) {
+        icu::StringByteSink<std::string> sink{&out, i32(str.size())};
+        norm->normalizeUTF8(0, icu::StringPiece(str.data(), i32(str.size())), sink, nullptr, ec);
+    } else {
+        auto ustr = ::UStr(str);
+        auto normalised = i32(norm->spanQuickCheckYes(ustr, ec));
+        if (normalised == ustr.length()) out += str;
+        else out += ::ExportUTF<CharTy>(norm->normalize(ustr, ec));
+    }
+}
+} // namespace
+
+bool text::IsNormalised(std::string_view str, NormalisationForm form) {
+    return IsNormalisedImpl(str, form);
+}
+
+bool text::IsNormalised(std::u32string_view str, NormalisationForm form) {
+    return IsNormalisedImpl(str, form);
+}
+
 auto text::Normalise(std::string_view str, NormalisationForm form) -> std::string {
-    return NormaliseImpl(str, form);
+    std::string out;
+    NormaliseIntoImpl(out, str, form);
+    return out;
 }
 
 auto text::Normalise(std::u32string_view str, NormalisationForm form) -> std::u32string {
-    return NormaliseImpl(str, form);
+    std::u32string out;
+    NormaliseIntoImpl(out, str, form);
+    return out;
+}
+
+void text::NormaliseInto(std::string& out, std::string_view str, NormalisationForm form) {
+    NormaliseIntoImpl(out, str, form);
+}
+
+void text::NormaliseInto(std::u32string& out, std::u32string_view str, NormalisationForm form) {
+    NormaliseIntoImpl(out, str, form);
 }
 
 /// ====================================================================
 ///  Case Conversion
 /// ====================================================================
 namespace {
-template <typename CharTy>
-[[nodiscard]] auto ToLowerImpl(std::basic_string_view<CharTy> str) -> std::basic_string<CharTy> {
-    auto ustr = ::UStr(str);
-    ustr.toLower();
-    return ::ExportUTF<CharTy>(ustr);
+#    ifdef LIBBASE_SIMD_X86
+template <bool Upper>
+LIBBASE_TARGET_AVX2 auto MapASCIICaseAVX2(const char* in, usz n, char* out) -> usz {
+    // Move the letters we’re looking for to the bottom of the signed
+    // range so a single comparison tells us which bytes to flip.
+    const auto offset = _mm256_set1_epi8(char(0x80 - (Upper ? 'a' : 'A')));
+    const auto limit = _mm256_set1_epi8(char(0x80 + 26));
+    const auto case_bit = _mm256_set1_epi8(0x20);
+
+    usz i = 0;
+    for (; i + 32 <= n; i += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        auto letters = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, offset));
+        v = _mm256_xor_si256(v, _mm256_and_si256(letters, case_bit));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+    }
+
+    return i;
 }
+#    endif
+
+/// Convert ASCII letters to lower or upper case.
+template <bool Upper, typename CharTy>
+void MapASCIICase(const CharTy* in, usz n, CharTy* out) {
+    usz i = 0;
+#    ifdef LIBBASE_SIMD_X86
+    if constexpr (sizeof(CharTy) == 1) {
+        if (n >= 32 and detail::HasAVX2()) i = MapASCIICaseAVX2<Upper>(in, n, out);
+    }
+#    endif
+
+    // This is branch-free so the compiler can vectorise it.
+    constexpr u32 first = Upper ? 'a' : 'A';
+    for (; i < n; i++) {
+        auto c = u32(std::make_unsigned_t<CharTy>(in[i]));
+        out[i] = CharTy(c ^ u32(c - first < 26) << 5);
+    }
+}
+
+template <bool Upper, typename CharTy>
+void MapCaseInto(std::basic_string<CharTy>& out, std::basic_string_view<CharTy> str) {
+    // Outside of ASCII, case mapping depends on context (e.g. the Greek
+    // final sigma), so only take the fast path if the entire string is ASCII.
+    if (detail::AsciiPrefix(str) == str.size()) {
+        auto pos = out.size();
+        out.resize_and_overwrite(pos + str.size(), [&](CharTy* buf, usz n) {
+            MapASCIICase<Upper>(str.data(), str.size(), buf + pos);
+            return n;
+        });
+        return;
+    }
 
-template <typename CharTy>
-[[nodiscard]] auto ToUpperImpl(std::basic_string_view<CharTy> str) -> std::basic_string<CharTy> {
     auto ustr = ::UStr(str);
-    ustr.toUpper();
-    return ::ExportUTF<CharTy>(ustr);
+    if constexpr (Upper) ustr.toUpper();
+    else ustr.toLower();
+    out += ::ExportUTF<CharTy>(ustr);
+}
+
+template <bool Upper, typename CharTy>
+[[nodiscard]] auto MapCase(std::basic_string_view<CharTy> str) -> std::basic_string<CharTy> {
+    std::basic_string<CharTy> out;
+    MapCaseInto<Upper>(out, str);
+    return out;
 }
 } // namespace
 
 auto text::ToLower(std::string_view str) -> std::string {
-    return ToLowerImpl(str);
+    return MapCase<false>(str);
 }
 
 auto text::ToLower(std::u32string_view str) -> std::u32string {
-    return ToLowerImpl(str);
+    return MapCase<false>(str);
 }
 
 auto text::ToUpper(std::string_view str) -> std::string {
-    return ToUpperImpl(str);
+    return MapCase<true>(str);
 }
 
 auto text::ToUpper(std::u32string_view str) -> std::u32string {
-    return ToUpperImpl(str);
+    return MapCase<true>(str);
 }
 
-/// ====================================================================
-///  Conversion
-/// ====================================================================
-auto text::ToUTF8(std::u16string_view str) -> std::string { return ExportUTF<char>(UStr(str)); }
-auto text::ToUTF8(std::u32string_view str) -> std::string { return ExportUTF<char>(UStr(str)); }
-auto text::ToUTF8(c32 c) -> std::string { return ExportUTF<char>(UStr(std::u32string_view{&c.value, 1})); }
+void text::ToLowerInto(std::string& out, std::string_view str) {
+    MapCaseInto<false>(out, str);
+}
 
-auto text::ToUTF16(std::string_view str) -> std::u16string { return ExportUTF<char16_t>(UStr(str)); }
-auto text::ToUTF16(std::u32string_view str) -> std::u16string { return ExportUTF<char16_t>(UStr(str)); }
-auto text::ToUTF16(c32 c) -> std::u16string { return ExportUTF<char16_t>(UStr(std::u32string_view{&c.value, 1})); }
+void text::ToLowerInto(std::u32string& out, std::u32string_view str) {
+    MapCaseInto<false>(out, str);
+}
+
+void text::ToUpperInto(std::string& out, std::string_view str) {
+    MapCaseInto<true>(out, str);
+}
 
-auto text::ToUTF32(std::string_view str) -> std::u32string { return ExportUTF<char32_t>(UStr(str)); }
-auto text::ToUTF32(std::u16string_view str) -> std::u32string { return ExportUTF<char32_t>(UStr(str)); }
+void text::ToUpperInto(std::u32string& out, std::u32string_view str) {
+    MapCaseInto<true>(out, str);
+}
 
 #endif
@@ -0,0 +1,188 @@
+#include <base/Text.hh>
+#include <base/detail/SIMD.hh>
+#include <base/detail/UTF.hh>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+using namespace base;
+using namespace base::text;
+
+/// ====================================================================
+///  ASCII Fast Paths
+/// ====================================================================
+namespace {
+template <typename Char>
+auto AsciiPrefixScalar(const Char* data, usz size) -> usz {
+    usz i = 0;
+
+    // Check 8 bytes at a time.
+    if constexpr (sizeof(Char) == 1) {
+        for (; i + 8 <= size; i += 8) {
+            u64 v;
+            std::memcpy(&v, data + i, 8);
+            if (v & 0x8080'8080'8080'8080) break;
+        }
+    }
+
+    for (; i < size; i++)
+        if (u32(std::make_unsigned_t<Char>(data[i])) >= 0x80)
+            break;
+
+    return i;
+}
+
+template <typename Char>
+void CopyASCII(const auto* in, usz n, Char* out) {
+    for (usz i = 0; i < n; i++) out[i] = Char(in[i]);
+}
+
+#ifdef LIBBASE_SIMD_X86
+template <typename Char>
+LIBBASE_TARGET_AVX2 auto AsciiPrefixAVX2(const Char* data, usz size) -> usz {
+    constexpr usz N = 32 / sizeof(Char);
+    __m256i mask;
+    if constexpr (sizeof(Char) == 1) mask = _mm256_set1_epi8(char(0x80));
+    else if constexpr (sizeof(Char) == 2) mask = _mm256_set1_epi16(i16(0xFF80));
+    else mask = _mm256_set1_epi32(i32(0xFFFF'FF80));
+
+    usz i = 0;
+    for (; i + N <= size; i += N) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        if (not _mm256_testz_si256(v, mask)) break;
+    }
+
+    return i + AsciiPrefixScalar(data + i, size - i);
+}
+
+/// Zero-extend ASCII bytes to UTF-16 or UTF-32 code units.
+template <typename Char>
+LIBBASE_TARGET_AVX2 void WidenASCIIAVX2(const char* in, usz n, Char* out) {
+    usz i = 0;
+    if constexpr (sizeof(Char) == 2) {
+        for (; i + 16 <= n; i += 16) {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtepu8_epi16(v));
+        }
+    } else {
+        for (; i + 8 <= n; i += 8) {
+            auto v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtepu8_epi32(v));
+        }
+    }
+
+    CopyASCII(in + i, n - i, out + i);
+}
+#endif
+
+/// Get the number of code units at the start of a string that are ASCII.
+template <typename Char>
+auto AsciiPrefix(const Char* data, usz size) -> usz {
+#ifdef LIBBASE_SIMD_X86
+    if (size >= 32 / sizeof(Char) and detail::HasAVX2()) return AsciiPrefixAVX2(data, size);
+#endif
+    return AsciiPrefixScalar(data, size);
+}
+
+/// Convert ASCII characters from one encoding to another.
+template <typename In, typename Out>
+void ConvertASCII(const In* in, usz n, Out* out) {
+    if constexpr (std::is_same_v<In, Out>) {
+        std::memcpy(out, in, n * sizeof(In));
+    } else {
+#ifdef LIBBASE_SIMD_X86
+        if constexpr (sizeof(In) == 1) {
+            if (n >= 32 and detail::HasAVX2()) return WidenASCIIAVX2(in, n, out);
+        }
+#endif
+        CopyASCII(in, n, out);
+    }
+}
+
+/// ====================================================================
+///  Transcoding
+/// ====================================================================
+auto Decode(const char*& it, const char* end) -> char32_t { return detail::DecodeUTF8(it, end); }
+auto Decode(const char16_t*& it, const char16_t* end) -> char32_t { return detail::DecodeUTF16(it, end); }
+auto Decode(const char32_t*& it, const char32_t* end) -> char32_t { return detail::DecodeUTF32(it, end); }
+auto Encode(char32_t c, char* out) -> usz { return detail::EncodeUTF8(c, out); }
+auto Encode(char32_t c, char16_t* out) -> usz { return detail::EncodeUTF16(c, out); }
+auto Encode(char32_t c, char32_t* out) -> usz { return detail::EncodeUTF32(c, out); }
+
+/// Get the maximum number of code units that a string of 'n' code
+/// units could need when converted to another encoding.
+template <typename In, typename Out>
+constexpr auto MaxSize(usz n) -> usz {
+    // A code point takes at most 3 bytes in UTF-8 if it takes 1 unit in
+    // UTF-16 and at most 4 if it takes 1 unit in UTF-32; invalid units are
+    // replaced with U+FFFD, which takes 3 bytes.
+    if constexpr (sizeof(Out) == 1) return n * (sizeof(In) == 2 ? 3 : sizeof(In) == 4 ? 4 : 1);
+
+    // Any code point that takes 2 units in UTF-16 takes 4 bytes in UTF-8.
+    if constexpr (sizeof(Out) == 2) return n * (sizeof(In) == 4 ? 2 : 1);
+    return n;
+}
+
+template <typename Out, typename In>
+auto Convert(std::basic_string_view<In> in) -> std::basic_string<Out> {
+    std::basic_string<Out> out;
+    out.resize_and_overwrite(MaxSize<In, Out>(in.size()), [&](Out* buf, usz) {
+        auto it = in.data();
+        auto end = in.data() + in.size();
+        auto o = buf;
+        while (it != end) {
+            // Convert ASCII characters in bulk.
+            auto n = AsciiPrefix(it, usz(end - it));
+            ConvertASCII(it, n, o);
+            it += n;
+            o += n;
+
+            // Transcode everything else until we get back to ASCII.
+            while (it != end and u32(std::make_unsigned_t<In>(*it)) >= 0x80)
+                o += Encode(Decode(it, end), o);
+        }
+        return usz(o - buf);
+    });
+    return out;
+}
+} // namespace
+
+auto detail::AsciiPrefix(std::string_view str) -> usz { return ::AsciiPrefix(str.data(), str.size()); }
+auto detail::AsciiPrefix(std::u16string_view str) -> usz { return ::AsciiPrefix(str.data(), str.size()); }
+auto detail::AsciiPrefix(std::u32string_view str) -> usz { return ::AsciiPrefix(str.data(), str.size()); }
+
+auto text::ToUTF8(std::u16string_view str) -> std::string { return Convert<char>(str); }
+auto text::ToUTF8(std::u32string_view str) -> std::string { return Convert<char>(str); }
+auto text::ToUTF8(c32 c) -> std::string {
+    char buf[4];
+    return {buf, detail::EncodeUTF8(c.value, buf)};
+}
+
+auto text::ToUTF16(std::string_view str) -> std::u16string { return Convert<char16_t>(str); }
+auto text::ToUTF16(std::u32string_view str) -> std::u16string { return Convert<char16_t>(str); }
+auto text::ToUTF16(c32 c) -> std::u16string {
+    char16_t buf[2];
+    return {buf, detail::EncodeUTF16(c.value, buf)};
+}
+
+auto text::ToUTF32(std::string_view str) -> std::u32string { return Convert<char32_t>(str); }
+auto text::ToUTF32(std::u16string_view str) -> std::u32string { return Convert<char32_t>(str); }
+
+/// ====================================================================
+///  Validation
+/// ====================================================================
+auto text::ValidateUTF8(std::string_view str) -> Result<> {
+    auto it = str.data();
+    auto end = str.data() + str.size();
+    while (it != end) {
+        it += AsciiPrefix(it, usz(end - it));
+        while (it != end and u8(*it) >= 0x80) {
+            auto start = it;
+            if (not detail::TryDecodeUTF8(it, end)) return Error(
+                "Invalid UTF-8 at offset {}",
+                usz(start - str.data())
+            );
+        }
+    }
+    return {};
+}
@@ -0,0 +1,5 @@
+#include <base/Text.hh>
+
+namespace base::detail {
+#include "UnicodeTables.inc"
+} // namespace base::detail
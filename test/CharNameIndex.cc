@@ -0,0 +1,60 @@
+#include "TestCommon.hh"
+
+#include <base/CharNameIndex.hh>
+#include <base/Serialisation.hh>
+
+using namespace base;
+using namespace base::text;
+
+#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
+TEST_CASE("CharNameIndex: Queries") {
+    auto& idx = CharNameIndex::Get();
+    CHECK(idx.size() > 10'000);
+    CHECK(idx.name(U'A') == "LATIN CAPITAL LETTER A");
+    CHECK(idx.name(U'🌈') == "RAINBOW");
+    CHECK(idx.name(U'\n') == std::nullopt);
+
+    auto hearts = idx.find("heavy black heart");
+    CHECK(rgs::contains(hearts, c32(U'❤')));
+    CHECK(rgs::all_of(hearts, [&](c32 c) { return idx.name(c)->contains("HEAVY BLACK HEART"); }));
+    CHECK(idx.find("no character is called this").empty());
+    CHECK(rgs::contains(idx.find("Pi"), c32(U'π')));
+
+    // The index should agree with a linear scan.
+    auto expected = idx.find_if([](c32, std::string_view name) { return name.contains("DOUBLE ARROW"); });
+    CHECK(idx.find("double arrow") == expected);
+    CHECK(not expected.empty());
+}
+
+TEST_CASE("CharNameIndex: Build a range") {
+    auto idx = CharNameIndex::Build(U'A', U'Z');
+    CHECK(idx.size() == 26);
+    CHECK(idx.find("LETTER").size() == 26);
+    CHECK(idx.find("LETTER Q") == std::vector<c32>{U'Q'});
+    CHECK(idx.find_if([](c32, std::string_view) { return true; }, U'X') == std::vector<c32>{U'X', U'Y', U'Z'});
+}
+
+TEST_CASE("CharNameIndex: Serialisation") {
+    auto idx = CharNameIndex::Build(U'\0', U'\u03FF');
+    auto bytes = ser::Serialise<std::endian::little>(idx);
+    auto loaded = ser::Deserialise<CharNameIndex, std::endian::little>(bytes).value();
+    CHECK(loaded.size() == idx.size());
+    CHECK(loaded.find("greek small letter") == idx.find("greek small letter"));
+    CHECK(loaded.name(U'ß') == "LATIN SMALL LETTER SHARP S");
+
+    // Corrupt data should be rejected.
+    bytes.resize(bytes.size() - 1);
+    CHECK(not ser::Deserialise<CharNameIndex, std::endian::little>(bytes).has_value());
+}
+#endif
+
+TEST_CASE("CharNameIndex: Empty index") {
+    CharNameIndex idx;
+    CHECK(idx.size() == 0);
+    CHECK(idx.find("A").empty());
+    CHECK(idx.find("LETTER").empty());
+    CHECK(idx.name(U'A') == std::nullopt);
+
+    auto bytes = ser::Serialise<std::endian::big>(idx);
+    CHECK(ser::Deserialise<CharNameIndex, std::endian::big>(bytes).value().size() == 0);
+}
@@ -0,0 +1,91 @@
+#include "TestCommon.hh"
+
+#include <base/CharSet.hh>
+#include <base/Str.hh>
+
+using namespace base;
+
+TEST_CASE("CharSet: Basic operations") {
+    static constexpr CharSet s{"abc\xff"};
+    static_assert(s.contains('a'));
+    static_assert(s.contains('\xff'));
+    static_assert(s.contains(u8(0xff)));
+    static_assert(not s.contains('d'));
+    static_assert(not s.contains(U'š'));
+    static_assert(s.size() == 4);
+    static_assert(not s.empty());
+    static_assert(CharSet().empty());
+    static_assert((~s).size() == 252);
+    static_assert((s | CharSet{"xy"}).size() == 6);
+    static_assert((s & CharSet{"ax"}) == CharSet{"a"});
+    static_assert(s.find_first(std::string_view{"xyzb"}) == 3);
+    static_assert(s.find_first_not(std::string_view{"abqc"}) == 2);
+    static_assert(s.count(std::string_view{"aaxbb"}) == 4);
+}
+
+TEST_CASE("CharSet: Scanning long inputs") {
+    // Make sure we exercise both the vectorised code and the tail.
+    std::string text;
+    for (int i = 0; i < 1000; i++) text += char(i * 7 % 256);
+    const CharSet sets[]{CharSet{"\n"}, CharSet{" \t\r\n"}, CharSet{"\x80\xfe\x01"}, ~CharSet{"abc"}, CharSet{}};
+    for (const auto& set : sets) {
+        for (usz start = 0; start < 70; start++) {
+            std::string_view sv = std::string_view{text}.substr(start);
+            usz expected = 0;
+            for (char c : sv) expected += set.contains(c);
+            CHECK(set.count(sv) == expected);
+
+            auto first = usz(std::ranges::find_if(sv, [&](char c) { return set.contains(c); }) - sv.begin());
+            auto first_not = usz(std::ranges::find_if(sv, [&](char c) { return not set.contains(c); }) - sv.begin());
+            CHECK(set.find_first(sv) == first);
+            CHECK(set.find_first_not(sv) == first_not);
+        }
+    }
+}
+
+TEST_CASE("CharSet: str overloads") {
+    static constexpr CharSet ws{" \t\n"};
+    str s = "foo bar\tbaz\nquux";
+    CHECK(s.contains_any(ws));
+    CHECK(not str("foobar").contains_any(ws));
+    CHECK(s.count_any(ws) == 3);
+    CHECK(s.first_any(ws) == 3);
+    CHECK(str("foo").first_any(ws) == std::nullopt);
+    CHECK(s.take_until_any(ws) == "foo");
+    CHECK(s.drop_until_any(CharSet{"\t"}) == "\tbaz\nquux");
+    CHECK(s.take_until_any_or_empty(CharSet{"!"}) == "");
+    CHECK(s == "\tbaz\nquux");
+    CHECK(s.drop_until_any_or_empty(CharSet{"q"}) == "quux");
+    CHECK(s.take_until_any(CharSet{"!"}) == "quux");
+    CHECK(s.empty());
+    CHECK(str32(U"a bš ").count_any(ws) == 2);
+}
+
+TEST_CASE("CharSet: Compile-time character classes") {
+    static constexpr auto Ident = CharSet::FromPredicate(text::IsAlnum) | "_"_cs;
+    static constexpr auto Hex = CharSet::FromPredicate(text::IsXDigit);
+    static_assert(Ident.size() == 63);
+    static_assert(Hex == (CharSet::FromRange('0', '9') | CharSet::FromRange('a', 'f') | CharSet::FromRange('A', 'F')));
+    static_assert("abc"_cs == CharSet{"cba"});
+    static_assert(CharSet::FromRange('\x80', '\xff').size() == 128);
+
+    str s = "foo_bar1 = 0x1fz";
+    CHECK(s.take_while(Ident) == "foo_bar1");
+    CHECK(s.trim_front(CharSet::FromPredicate(text::IsSpace)) == "= 0x1fz");
+    CHECK(s.drop_until(Hex).drop(2).take_while_any(Hex) == "1f");
+    CHECK(s == "z");
+
+    str t = "  \t foo bar \n ";
+    CHECK(str(t).trim(" \t\n"_cs) == "foo bar");
+    CHECK(str(t).trim_back(" \n"_cs) == "  \t foo bar");
+    CHECK(str(t).take_back_while_any(" \n"_cs) == " \n ");
+    CHECK(str(t).drop_while_any(" \t"_cs).take_until(" "_cs) == "foo");
+    CHECK(str(t).drop_while(" "_cs) == "\t foo bar \n ");
+    CHECK(str(t).drop_back_while_any(" "_cs) == "  \t foo bar \n");
+    CHECK(str("   ").trim(" "_cs).empty());
+
+    static_assert([] {
+        str s = "  abc  ";
+        return s.trim(" "_cs) == "abc";
+    }());
+}
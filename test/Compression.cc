@@ -21,4 +21,68 @@ TEST_CASE("Compression tests") {
     CHECK(s + s == ByteSpan(decompressed).str());
 }
 
+TEST_CASE("Compression: Streaming") {
+    struct Buffer {
+        std::vector<std::byte> data;
+        usz pos = 0;
+
+        auto write(ByteSpan bytes) -> Result<> {
+            data.insert(data.end(), bytes.begin(), bytes.end());
+            return {};
+        }
+
+        auto read(MutableByteSpan into) -> Result<usz> {
+            auto n = std::min(into.size(), data.size() - pos);
+            std::copy_n(data.begin() + isz(pos), n, into.begin());
+            pos += n;
+            return n;
+        }
+    };
+
+    std::vector<std::string> lines;
+    std::vector<u64> numbers;
+    for (u64 i = 0; i < 10'000; i++) {
+        lines.push_back(std::format("line {}", i));
+        numbers.push_back(i * i);
+    }
+
+    auto value = std::tuple{lines, numbers};
+    auto Roundtrip = [&](bool checksums) {
+        Buffer compressed;
+        {
+            CompressingSink sink{compressed, 16 * 1024, std::nullopt, checksums};
+            ser::Writer<std::endian::little> w{sink, 4096};
+            w << value;
+            REQUIRE(w.flush().has_value());
+            REQUIRE(sink.flush().has_value());
+        }
+
+        CHECK(compressed.data.size() < ser::Serialise<std::endian::little>(value).size());
+        DecompressingSource source{compressed, 1000};
+        CHECK(ser::Deserialise<decltype(value), std::endian::little>(source).value() == value);
+        return std::move(compressed.data);
+    };
+
+    auto with_checksums = Roundtrip(true);
+    auto without_checksums = Roundtrip(false);
+    CHECK(without_checksums.size() < with_checksums.size());
+
+    SECTION("Corrupted data") {
+        Buffer corrupted{with_checksums};
+        corrupted.data[corrupted.data.size() / 2] ^= std::byte(0x42);
+        DecompressingSource source{corrupted};
+        CHECK(not ser::Deserialise<decltype(value), std::endian::little>(source).has_value());
+    }
+
+    SECTION("Truncated data") {
+        Buffer truncated{with_checksums};
+        truncated.data.resize(truncated.data.size() / 2);
+        DecompressingSource source{truncated};
+        CHECK(
+            ser::Deserialise<decltype(value), std::endian::little>(source).error()
+            == "Decompression failed: Compressed data is truncated"
+        );
+    }
+}
+
 #endif // LIBBASE_ENABLE_ZSTD
@@ -0,0 +1,45 @@
+#include "TestCommon.hh"
+
+#include <base/LineIndex.hh>
+
+using namespace base;
+using Catch::Matchers::RangeEquals;
+
+TEST_CASE("LineIndex: Basic operations") {
+    str text = "foo\nbar\n\nbaz\n";
+    LineIndex idx{text};
+    REQUIRE(idx.size() == 5);
+    CHECK(idx[0] == "foo");
+    CHECK(idx[1] == "bar");
+    CHECK(idx[2] == "");
+    CHECK(idx[3] == "baz");
+    CHECK(idx[4] == "");
+    CHECK(idx.offset(3) == 9);
+    CHECK(idx.line_containing(0) == 0);
+    CHECK(idx.line_containing(3) == 0);
+    CHECK(idx.line_containing(4) == 1);
+    CHECK(idx.line_containing(9) == 3);
+    CHECK(idx.line_containing(13) == 4);
+    CHECK_THAT(idx.lines(), RangeEquals(text.lines()));
+    CHECK_THROWS(idx[5]);
+
+    CHECK(LineIndex{""}.empty());
+    CHECK(LineIndex32{"foo"}.size() == 1);
+    CHECK(LineIndex32{"foo"}[0] == "foo");
+}
+
+TEST_CASE("LineIndex: Matches str::lines()") {
+    std::string text;
+    for (int i = 0; i < 300'000; i++) text += std::string(usz(i % 37), 'x') + (i % 3 ? "\n" : "\n\n");
+    text += "end";
+
+    auto expected = str{text}.lines() | rgs::to<std::vector>();
+    LineIndex32 single{text};
+    LineIndex parallel{text, 4};
+    REQUIRE(single.size() == expected.size());
+    REQUIRE(parallel.size() == expected.size());
+    for (usz i = 0; i < expected.size(); i++) {
+        CHECK(single[i] == expected[i]);
+        CHECK(parallel[i] == expected[i]);
+    }
+}
@@ -59,3 +59,77 @@ TEST_CASE("Try() also works with std::expected") {
     CHECK(DoIt(true).value() == "foobarbaz");
     CHECK(DoIt(false).error() == 42);
 }
+
+TEST_CASE("Result<T, CompactError>") {
+    auto Read = [](usz n, usz size) -> Result<usz, CompactError> {
+        if (n > size) return Error(ErrorCode::NotEnoughData, "Not enough data to read {} bytes ({} bytes left)", n, size);
+        return n;
+    };
+
+    SECTION("Error code and message") {
+        auto res = Read(5, 4);
+        REQUIRE(not res.has_value());
+        CHECK(res.error().code() == ErrorCode::NotEnoughData);
+        CHECK(res.error().message() == "Not enough data to read 5 bytes (4 bytes left)");
+        CHECK(res.error() == "Not enough data to read 5 bytes (4 bytes left)");
+    }
+
+    SECTION("String arguments are copied") {
+        auto Fail = [](std::string s) -> Result<void, CompactError> {
+            return Error(ErrorCode::InvalidInput, "Invalid input '{}'", s);
+        };
+
+        CHECK(Fail("foo").error() == "Invalid input 'foo'");
+        CHECK(Fail(std::string(100, 'x')).error() == std::format("Invalid input '{}'", std::string(100, 'x')));
+        CHECK(Fail("").error().code() == ErrorCode::InvalidInput);
+    }
+
+    SECTION("std::errc is formatted as a message") {
+        Result<void, CompactError> res = Error(ErrorCode::OutOfRange, "{}", std::errc::result_out_of_range);
+        CHECK(res.error() == std::make_error_code(std::errc::result_out_of_range).message());
+    }
+
+    SECTION("Conversion to and from Result<T>") {
+        auto Convert = [&](usz n) -> Result<usz> { return Read(n, 4); };
+        auto Unwrap = [&](usz n) -> Result<bool> { return Try(Read(n, 4)) == 3; };
+        auto Wrap = [] -> Result<int, CompactError> { return Error("Error {}", 42); };
+
+        CHECK(Convert(3).value() == 3);
+        CHECK(Convert(5).error() == "Not enough data to read 5 bytes (4 bytes left)");
+        CHECK(Unwrap(3).value());
+        CHECK(Unwrap(5).error() == "Not enough data to read 5 bytes (4 bytes left)");
+        CHECK(Wrap().error() == "Error 42");
+        CHECK(Wrap().error().code() == ErrorCode::Other);
+    }
+
+    SECTION("Result<bool> conversion preserves the value") {
+        auto Get = [](bool ok) -> Result<bool> {
+            Result<bool, CompactError> res = false;
+            if (not ok) res = Error(ErrorCode::InvalidInput, "Invalid");
+            return res;
+        };
+
+        CHECK(Get(true).value() == false);
+        CHECK(Get(false).error() == "Invalid");
+    }
+
+    SECTION("Copying and assignment") {
+        auto lazy = Read(5, 4).error();
+        CompactError formatted = std::string{"Formatted"};
+        CompactError copy = lazy;
+        CHECK(copy == "Not enough data to read 5 bytes (4 bytes left)");
+        copy = formatted;
+        CHECK(copy == "Formatted");
+        copy = std::move(lazy);
+        CHECK(copy == "Not enough data to read 5 bytes (4 bytes left)");
+        CHECK(copy.code() == ErrorCode::NotEnoughData);
+    }
+
+    SECTION("Size") {
+        static_assert(sizeof(Result<usz, CompactError>) <= sizeof(Result<usz>) + 2 * sizeof(void*));
+    }
+
+    SECTION("value() throws the message") {
+        CHECK_THROWS_WITH(Read(5, 4).value(), ContainsSubstring("Not enough data to read 5 bytes (4 bytes left)"));
+    }
+}
@@ -0,0 +1,58 @@
+#include "TestCommon.hh"
+
+#include <base/Str.hh>
+
+using namespace base;
+using Catch::Matchers::RangeEquals;
+
+TEST_CASE("Searcher: Basic operations") {
+    static constexpr searcher s{"abc"};
+    static_assert(s.find("xxabcabc") == 2);
+    static_assert(s.find("xxabcabc", 3) == 5);
+    static_assert(s.find("xxabab") == searcher::npos);
+    static_assert(s.find("ab") == searcher::npos);
+    static_assert(s.find("abc", 4) == searcher::npos);
+    static_assert(searcher{""}.find("abc", 2) == 2);
+
+    CHECK(s.find("xxabcabc") == 2);
+    CHECK(s.find("xxabcabc", 3) == 5);
+    CHECK(s.find("xxabab") == searcher::npos);
+    CHECK(searcher{"b"}.find("aaab") == 3);
+    CHECK(u32searcher{U"šš"}.find(U"ašbššc") == 3);
+}
+
+TEST_CASE("Searcher: Long inputs") {
+    // Make sure we exercise both the vectorised code and the tail.
+    std::string text;
+    for (int i = 0; i < 500; i++) text += char('a' + i * 7 % 5);
+    const std::string_view needles[]{"a", "ab", "abc", "cadb", "eb", "bcdea", "zz", "dbeacdbeacdbeacdbeacdbeacdbeacdbeacdbeacdbea"};
+    for (auto needle : needles) {
+        searcher s{needle};
+        for (usz start = 0; start < 70; start++) {
+            std::string_view sv = std::string_view{text}.substr(start);
+            for (usz from = 0; from < 3; from++) CHECK(s.find(sv, from) == sv.find(needle, from));
+        }
+    }
+}
+
+TEST_CASE("Searcher: str overloads") {
+    static constexpr std::string_view needle = "foo";
+    str::searcher s{needle};
+    str text = "xfoofooyfoz foo";
+    CHECK(text.contains(s));
+    CHECK(not str("fofo").contains(s));
+    CHECK(text.first(s) == 1);
+    CHECK(str("bar").first(s) == std::nullopt);
+    CHECK(text.count(s) == 3);
+    CHECK(str("aaaa").count(str::searcher{"aa"}) == 2);
+    CHECK(text.count(str::searcher{""}) == 0);
+    CHECK(text.replace(s, "bar") == "xbarbaryfoz bar");
+    CHECK(text.replace(str::searcher{""}, "bar") == text);
+
+    auto parts = text.split(s);
+    CHECK_THAT(parts, RangeEquals(std::vector{"x"sv, ""sv, "yfoz "sv, ""sv}));
+    CHECK_THAT(str("x\r\ny\r\n").split(str::searcher{"\r\n"}), RangeEquals(std::vector{"x"sv, "y"sv, ""sv}));
+    CHECK_THAT(str("abc").split(str::searcher{""}), RangeEquals(std::vector{"a"sv, "b"sv, "c"sv}));
+    CHECK(rgs::distance(str().split(s)) == 0);
+    CHECK(rgs::distance(str("bar").split(s)) == 1);
+}
@@ -381,6 +381,87 @@ TEST_CASE("Serialisation: std::vector") {
     }
 }
 
+TEST_CASE("Serialisation: Large vectors of arithmetic types") {
+    auto Check = [] <typename T> (usz n) {
+        std::vector<T> v(n);
+        for (usz i = 0; i < n; i++) v[i] = T(i * 0x0101'0101'0101 + 7);
+
+        // Compare the bulk encoding against that of each element.
+        auto be = SerialiseBE(v);
+        auto le = SerialiseLE(v);
+        REQUIRE(be.size() == sizeof(u64) + n * sizeof(T));
+        for (usz i = 0; i < n; i++) {
+            auto at = be.begin() + isz(sizeof(u64) + i * sizeof(T));
+            REQUIRE(ByteBuffer(at, at + isz(sizeof(T))) == SerialiseBE(v[i]));
+            at = le.begin() + isz(sizeof(u64) + i * sizeof(T));
+            REQUIRE(ByteBuffer(at, at + isz(sizeof(T))) == SerialiseLE(v[i]));
+        }
+
+        CHECK(DeserialiseBE<std::vector<T>>(be) == v);
+        CHECK(DeserialiseLE<std::vector<T>>(le) == v);
+    };
+
+    for (usz n : std::initializer_list<usz>{1, 3, 15, 16, 17, 100, 1'000}) {
+        Check.operator()<u16>(n);
+        Check.operator()<u32>(n);
+        Check.operator()<u64>(n);
+        Check.operator()<i32>(n);
+        Check.operator()<float>(n);
+        Check.operator()<double>(n);
+    }
+
+    SECTION("Size is larger than the input") {
+        auto b = SerialiseLE(std::vector<u32>{1, 2, 3});
+        b[7] = std::byte(0x10);
+        CHECK_THROWS(DeserialiseLE<std::vector<u32>>(b));
+    }
+}
+
+TEST_CASE("Serialisation: Views") {
+    auto strings = ser::Serialise<std::endian::native>(std::tuple{std::u32string{U"äöü"}, std::string{"foobar"}});
+    auto [u32sv, sv] = ser::Deserialise<std::tuple<std::u32string_view, std::string_view>, std::endian::native>(strings).value();
+    CHECK(u32sv == U"äöü");
+    CHECK(sv == "foobar");
+
+    // The views point into the buffer.
+    CHECK(static_cast<const void*>(u32sv.data()) == strings.data() + 8);
+    CHECK(static_cast<const void*>(sv.data()) == strings.data() + 28);
+
+    // Views are serialised the same way as their owning counterparts.
+    CHECK(SerialiseLE(sv) == SerialiseLE(std::string{"foobar"}));
+    CHECK(SerialiseBE(str{"foobar"}) == SerialiseBE(std::string{"foobar"}));
+    CHECK(DeserialiseBE<str>(SerialiseBE(std::string{"foobar"})).text() == "foobar");
+
+    auto bytes = Bytes(0, 0, 0, 0, 0, 0, 0, 3, 1, 2, 3);
+    CHECK(DeserialiseBE<ByteSpan>(bytes) == ByteSpan{Bytes(1, 2, 3)});
+    CHECK(SerialiseBE(ByteSpan{Bytes(1, 2, 3)}) == bytes);
+
+    std::vector<u32> ints{1, 2, 3, 4};
+    auto ints_bytes = ser::Serialise<std::endian::native>(ints);
+    auto span = ser::Deserialise<Span<u32>, std::endian::native>(ints_bytes).value();
+    CHECK(span == Span<u32>(ints));
+    CHECK(ser::Serialise<std::endian::native>(span) == ints_bytes);
+    CHECK(ser::Deserialise<Span<u32>, std::endian::native>(ByteBuffer{}).error() == "Not enough data to read 8 bytes (0 bytes left)");
+
+    SECTION("Empty views") {
+        CHECK(DeserialiseLE<std::string_view>(SerialiseLE(std::string{})).empty());
+        CHECK(ser::Deserialise<Span<u64>, std::endian::native>(ser::Serialise<std::endian::native>(std::vector<u64>{})).value().empty());
+    }
+
+    SECTION("Not enough data") {
+        CHECK_THROWS(DeserialiseLE<std::string_view>(6, 0, 0, 0, 0, 0, 0, 0, 'a', 'b'));
+        CHECK_THROWS(DeserialiseBE<ByteSpan>(0, 0, 0, 0, 0, 0, 0, 3, 1, 2));
+    }
+
+    SECTION("Misaligned data") {
+        ByteBuffer misaligned = Bytes(0);
+        ser::Serialise<std::endian::native>(misaligned, ints);
+        ser::Reader<std::endian::native> r{misaligned};
+        CHECK(r.read<u8>().value() == 0);
+        CHECK_THAT(r.read<Span<u32>>().error(), ContainsSubstring("not aligned to 4 bytes"));
+    }
+}
+
 TEST_CASE("Serialisation: std::deque") {
     std::deque<u8> a{1, 2, 3, 4, 5, 6};
     std::deque<u16> b{1, 2, 3, 4, 5, 6};
@@ -547,6 +628,325 @@ TEST_CASE("Serialisation: Reader::set_data()") {
     CHECK(not r.read<int>().has_value());
 }
 
+TEST_CASE("Serialisation: Sinks and sources") {
+    // Sink and source that only transfer a few bytes at a time.
+    struct Pipe {
+        ByteBuffer data;
+        std::vector<usz> chunks;
+        usz pos = 0;
+
+        auto write(ByteSpan bytes) -> Result<> {
+            chunks.push_back(bytes.size());
+            data.insert(data.end(), bytes.begin(), bytes.end());
+            return {};
+        }
+
+        auto read(MutableByteSpan into) -> Result<usz> {
+            auto n = std::min({into.size(), data.size() - pos, usz(5)});
+            std::copy_n(data.begin() + isz(pos), n, into.begin());
+            pos += n;
+            return n;
+        }
+    };
+
+    std::vector<u32> ints(1'000);
+    for (usz i = 0; i < ints.size(); i++) ints[i] = u32(i * 0x01010101);
+    auto value = std::tuple{std::string{"foobar"}, ints, std::map<std::string, int>{{"a", 1}, {"b", 2}}};
+
+    EndianBoth([&]<std::endian E> {
+        Pipe p;
+        {
+            ser::Writer<E> w{p, 64};
+            w << value;
+            CHECK(w.flush().has_value());
+        }
+
+        CHECK(p.data == ser::Serialise<E>(value));
+        CHECK(rgs::all_of(p.chunks, [](usz n) { return n <= 64 or n == 4'000; }));
+
+        ser::Reader<E> r{p, 16};
+        CHECK(r.template read<decltype(value)>().value() == value);
+        CHECK(not r.template read<u8>().has_value());
+    });
+
+    SECTION("Writer flushes on destruction") {
+        Pipe p;
+        { ser::WriterLE{p} << u32(42); }
+        CHECK(p.data == Bytes(42, 0, 0, 0));
+    }
+
+    SECTION("Callbacks") {
+        ByteBuffer out;
+        ser::WriterBE w{[&](ByteSpan bytes) -> Result<> {
+            out.insert(out.end(), bytes.begin(), bytes.end());
+            return {};
+        }};
+
+        w << u16(0x1234);
+        CHECK(w.flush().has_value());
+        CHECK(out == Bytes(0x12, 0x34));
+    }
+
+    SECTION("Write errors are reported by flush()") {
+        std::array<std::byte, 4> buf{};
+        ser::SpanSink sink{buf};
+        ser::WriterLE w{sink, 1};
+        w << u32(1) << u32(2);
+        CHECK(w.flush().error() == "Not enough space to write 4 bytes (0 bytes left)");
+        CHECK(sink.written().size() == 4);
+        CHECK(ser::Deserialise<u32, std::endian::little>(sink.written()).value() == 1);
+    }
+
+    SECTION("Source runs out of data") {
+        Pipe p;
+        p.data = SerialiseLE(ints);
+        p.data.resize(p.data.size() - 1);
+        CHECK_THAT(
+            (ser::Deserialise<std::vector<u32>, std::endian::little>(p).error()),
+            ContainsSubstring("Not enough data")
+        );
+    }
+
+    SECTION("Corrupt sizes don't allocate the entire size") {
+        Pipe p;
+        p.data = Bytes(1, 2, 3, 4, 5, 6, 7, 8);
+        ser::ReaderLE r{p, 16};
+        CHECK(r.read_bytes(usz(1) << 40).error() == "Not enough data to read 1099511627776 bytes (8 bytes left)");
+    }
+
+    SECTION("Views can't be read from a source") {
+        Pipe p;
+        p.data = SerialiseLE(std::string{"foo"});
+        CHECK(not ser::Deserialise<std::string_view, std::endian::little>(p).has_value());
+    }
+}
+
+TEST_CASE("Serialisation: Varints") {
+    auto SerialiseVarint = [](const auto& t) { return ser::Serialise<std::endian::little, ser::Encoding::Varint>(t); };
+    auto TestVarint = [&]<typename T>(const T& t, const ByteBuffer& bytes) {
+        CHECK(SerialiseVarint(t) == bytes);
+        CHECK(ser::Deserialise<T, std::endian::little, ser::Encoding::Varint>(bytes).value() == t);
+        auto big = ser::Serialise<std::endian::big, ser::Encoding::Varint>(t);
+        CHECK(ser::Deserialise<T, std::endian::big, ser::Encoding::Varint>(big).value() == t);
+    };
+
+    TestVarint(u32(0), Bytes(0));
+    TestVarint(u32(127), Bytes(0x7F));
+    TestVarint(u32(128), Bytes(0x80, 0x01));
+    TestVarint(u16(300), Bytes(0xAC, 0x02));
+    TestVarint(u64(-1), Bytes(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01));
+    TestVarint(i32(0), Bytes(0));
+    TestVarint(i32(-1), Bytes(1));
+    TestVarint(i32(1), Bytes(2));
+    TestVarint(i32(-64), Bytes(0x7F));
+    TestVarint(i64(std::numeric_limits<i64>::min()), Bytes(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01));
+
+    // Bytes, characters, and floats are not affected.
+    TestVarint(u8(200), Bytes(200));
+    TestVarint(std::string{"ab"}, Bytes(2, 'a', 'b'));
+    TestVarint(std::u16string{u"a"}, Bytes(1, 'a', 0));
+    TestVarint(1.f, Bytes(0, 0, 0x80, 0x3F));
+    TestVarint(1.0, Bytes(0, 0, 0, 0, 0, 0, 0xF0, 0x3F));
+    TestVarint(std::deque<float>{1.f}, Bytes(1, 0, 0, 0x80, 0x3F));
+    TestVarint(std::tuple<float, u32>{1.f, 300}, Bytes(0, 0, 0x80, 0x3F, 0xAC, 0x02));
+    CHECK(SerialiseVarint(std::vector<float>{1.f, 2.f}) == SerialiseVarint(std::deque<float>{1.f, 2.f}));
+    TestVarint(std::vector<u32>{1, 300, 2}, Bytes(3, 1, 0xAC, 0x02, 2));
+
+    SECTION("Runs of varints") {
+        std::vector<i64> ints;
+        for (i64 i = -1'000; i < 1'000; i++) ints.push_back(i * (i % 7 == 0 ? 1'000'003 : 1));
+        for (usz i = 0; i < 100; i++) ints.push_back(i64(i));
+        auto bytes = SerialiseVarint(ints);
+        CHECK(bytes.size() < ints.size() * sizeof(i64) / 2);
+        CHECK(ser::Deserialise<std::vector<i64>, std::endian::little, ser::Encoding::Varint>(bytes).value() == ints);
+
+        // Varints that straddle the end of the buffer of a source.
+        usz pos = 0;
+        ser::Reader<std::endian::little, ser::Encoding::Varint> r{
+            [&](MutableByteSpan into) -> Result<usz> {
+                auto n = std::min({into.size(), bytes.size() - pos, usz(3)});
+                std::copy_n(bytes.begin() + isz(pos), n, into.begin());
+                pos += n;
+                return n;
+            },
+            4,
+        };
+
+        CHECK(r.read<std::vector<i64>>().value() == ints);
+
+        std::vector<u16> small(1'000, 5);
+        small[500] = 1'000;
+        CHECK(ser::Deserialise<std::vector<u16>, std::endian::little, ser::Encoding::Varint>(SerialiseVarint(small)).value() == small);
+    }
+
+    SECTION("Invalid varints") {
+        auto Read = []<typename T>(const ByteBuffer& b) { return ser::Deserialise<T, std::endian::little, ser::Encoding::Varint>(b); };
+        CHECK(not Read.operator()<u32>(Bytes()).has_value());
+        CHECK(not Read.operator()<u32>(Bytes(0x80)).has_value());
+        CHECK(not Read.operator()<u64>(Bytes(0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00)).has_value());
+        CHECK(not Read.operator()<u64>(Bytes(0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02)).has_value());
+        CHECK(Read.operator()<u16>(Bytes(0x80, 0x80, 0x04)).error() == "Value 65536 does not fit in a 16-bit integer");
+        CHECK(not Read.operator()<std::vector<u32>>(Bytes(3, 1, 2)).has_value());
+    }
+}
+
+TEST_CASE("Serialisation: Serialised size") {
+    static_assert(ser::FixedSerialisedSize<u32> == 4);
+    static_assert(ser::FixedSerialisedSize<bool> == 1);
+    static_assert(ser::FixedSerialisedSize<u32enum> == 4);
+    static_assert(ser::FixedSerialisedSize<std::array<u16, 5>> == 10);
+    static_assert(ser::FixedSerialisedSize<std::tuple<u8, double, std::pair<i32, char>>> == 14);
+    static_assert(ser::FixedSerialisedSize<std::string> == std::nullopt);
+    static_assert(ser::FixedSerialisedSize<std::tuple<u8, std::string>> == std::nullopt);
+    static_assert(ser::FixedSerialisedSize<u32, ser::Encoding::Varint> == std::nullopt);
+    static_assert(ser::FixedSerialisedSize<float, ser::Encoding::Varint> == 4);
+
+    auto value = std::tuple{
+        std::string{"foobar"},
+        std::vector<std::u32string>{U"a", U"bc"},
+        std::map<u16, std::optional<i64>>{{1, 2}, {3, std::nullopt}},
+        std::variant<u8, double>{1.0},
+    };
+
+    CHECK(ser::SerialisedSize(value) == SerialiseLE(value).size());
+
+    SECTION("Floats with varint encoding") {
+        auto floats = std::tuple{1.f, -2.5, std::vector<float>{3.f, 4.f}, std::deque<double>{5.0}};
+        auto bytes = ser::Serialise<std::endian::little, ser::Encoding::Varint>(floats);
+        CHECK(ser::SerialisedSize<ser::Encoding::Varint>(floats) == bytes.size());
+        CHECK(ser::SerialisedSize<ser::Encoding::Varint>(1.f) == ser::Serialise<std::endian::little, ser::Encoding::Varint>(1.f).size());
+
+        std::array<std::byte, 4> buf;
+        CHECK(ser::Serialise<std::endian::little, ser::Encoding::Varint>(MutableByteSpan{buf}, 1.f).value() == 4);
+    }
+    CHECK(ser::SerialisedSize(u64(42)) == 8);
+    CHECK(ser::SerialisedSize<ser::Encoding::Varint>(value) == ser::Serialise<std::endian::little, ser::Encoding::Varint>(value).size());
+    CHECK(ser::SerialisedSize<ser::Encoding::Varint>(u64(42)) == 1);
+
+    SECTION("Serialise() allocates exactly once") {
+        auto bytes = SerialiseLE(value);
+        CHECK(bytes.capacity() == bytes.size());
+    }
+
+    SECTION("Serialising into a span") {
+        auto expected = SerialiseBE(value);
+        ByteBuffer buf(expected.size() + 3);
+        CHECK(ser::Serialise<std::endian::big>(MutableByteSpan{buf}, value).value() == expected.size());
+        CHECK(ByteBuffer(buf.begin(), buf.begin() + isz(expected.size())) == expected);
+
+        buf.resize(expected.size() - 1);
+        CHECK_THAT(
+            ser::Serialise<std::endian::big>(MutableByteSpan{buf}, value).error(),
+            ContainsSubstring("Not enough space")
+        );
+    }
+}
+
+TEST_CASE("Serialisation: Indexed ranges") {
+    std::vector<std::string> names;
+    for (int i = 0; i < 100; i++) names.push_back(std::format("name{}", i * i));
+
+    EndianBoth([&]<std::endian E> {
+        auto bytes = ser::Serialise<E>(ser::Indexed{names});
+        auto view = ser::Deserialise<ser::IndexedView<std::string_view>, E>(bytes).value();
+        REQUIRE(view.size() == names.size());
+        CHECK(view.at(99).value() == "name9801");
+        CHECK(view.at(0).value() == "name0");
+        CHECK(view.bytes(7).value().size() == sizeof(u64) + names[7].size());
+        CHECK(view.at(100).error() == "Index 100 is out of bounds for indexed range of size 100");
+
+        // Elements are stored the same way as in an ordinary vector.
+        CHECK(ser::Deserialise<std::string, E>(view.bytes(42).value()).value() == names[42]);
+
+        auto varint = ser::Serialise<E, ser::Encoding::Varint>(ser::Indexed{names});
+        auto varint_view = ser::Deserialise<ser::IndexedView<std::string>, E, ser::Encoding::Varint>(varint).value();
+        CHECK(varint_view.at(50).value() == names[50]);
+    });
+
+    SECTION("Maps") {
+        std::map<std::string, u32> map;
+        for (u32 i = 0; i < 100; i++) map[std::format("key{}", i)] = i;
+
+        EndianBoth([&]<std::endian E> {
+            auto bytes = ser::Serialise<E>(ser::Indexed{map});
+            auto view = ser::Deserialise<ser::IndexedMapView<std::string_view, u32>, E>(bytes).value();
+            REQUIRE(view.size() == map.size());
+            CHECK(view.find("key42").value() == 42);
+            CHECK(view.find(std::string{"key99"}).value() == 99);
+            CHECK(view.find("key100").value() == std::nullopt);
+            CHECK(view.contains("key0").value());
+            CHECK(not view.contains("").value());
+            CHECK(view.at(0).value() == std::pair<std::string_view, u32>{"key0", 0});
+        });
+
+        // Entries are sorted even if the map isn’t.
+        std::map<u32, u64, std::greater<>> reversed{{1, 10}, {2, 20}, {3, 30}};
+        auto bytes = SerialiseLE(ser::Indexed{reversed});
+        auto view = ser::Deserialise<ser::IndexedMapView<u32, u64>, std::endian::little>(bytes).value();
+        CHECK(view.key(0).value() == 1);
+        CHECK(view.key(2).value() == 3);
+        CHECK(view.find(2u).value() == 20);
+    }
+
+    SECTION("Invalid data") {
+        auto bytes = SerialiseLE(ser::Indexed{names});
+        CHECK_THAT(
+            ser::Deserialise<ser::IndexedView<std::string_view>, std::endian::little>(ByteSpan{bytes}.subspan(0, 100)).error(),
+            ContainsSubstring("Not enough data")
+        );
+
+        // Corrupt the end offset of the first element.
+        bytes[23] = std::byte(0xff);
+        auto view = ser::Deserialise<ser::IndexedView<std::string_view>, std::endian::little>(bytes).value();
+        CHECK_THAT(view.at(0).error(), ContainsSubstring("Invalid offsets for element 0"));
+        CHECK(view.at(2).value() == names[2]);
+
+        ser::ReaderLE r{[](MutableByteSpan) -> Result<usz> { return 0; }};
+        CHECK(
+            r.read<ser::IndexedView<std::string_view>>().error()
+            == "Cannot create a view of data that is read from a source"
+        );
+    }
+}
+
+TEST_CASE("Serialisation: Parallel") {
+    std::vector<std::string> strings;
+    for (int i = 0; i < 10'000; i++) strings.push_back(std::format("string {}", i));
+
+    EndianBoth([&]<std::endian E> {
+        for (usz threads : std::initializer_list<usz>{1, 2, 4, 7}) {
+            auto bytes = ser::Serialise<E>(ser::Parallel{strings, threads});
+            CHECK(ser::Deserialise<ser::Parallel<std::vector<std::string>>, E>(bytes).value().range == strings);
+            CHECK(ser::SerialisedSize(ser::Parallel{strings, threads}) == bytes.size());
+
+            auto varint = ser::Serialise<E, ser::Encoding::Varint>(ser::Parallel{strings, threads});
+            CHECK(ser::Deserialise<ser::Parallel<std::vector<std::string>>, E, ser::Encoding::Varint>(varint).value().range == strings);
+        }
+    });
+
+    // Small ranges are serialised as a single chunk.
+    std::vector<u32> ints{1, 2, 3};
+    auto bytes = SerialiseLE(ser::Parallel{ints, 8});
+    CHECK(bytes == SerialiseLE(std::tuple{u64(3), u64(1), u64(3), u64(12), u32(1), u32(2), u32(3)}));
+    CHECK(DeserialiseLE<ser::Parallel<std::vector<u32>>>(bytes).range == ints);
+
+    SECTION("Invalid data") {
+        bytes[16] = std::byte(2);
+        CHECK(
+            ser::Deserialise<ser::Parallel<std::vector<u32>>, std::endian::little>(bytes).error()
+            == "Chunks contain 2 elements, but expected 3"
+        );
+
+        bytes[16] = std::byte(3);
+        bytes[24] = std::byte(16);
+        bytes.resize(bytes.size() + 4);
+        CHECK(
+            ser::Deserialise<ser::Parallel<std::vector<u32>>, std::endian::little>(bytes).error()
+            == "Chunk 0 contains 4 bytes of trailing data"
+        );
+    }
+}
+
 /*TEST_CASE("Serialisation: Magic number") {
     static constexpr auto M1 = ser::Magic("1234");
     static constexpr auto M2 = ser::Magic{'1', u8(2), std::byte(3), '4'};
@@ -625,6 +1025,91 @@ TEST_CASE("Serialisation: private members") {
     Test(S{42}, Bytes(0, 0, 0, 42), Bytes(42, 0, 0, 0));
 }
 
+namespace {
+struct Sample {
+    LIBBASE_SERIALISE(Sample, timestamp, value, id, flags, channel);
+    u64 timestamp;
+    double value;
+    u32 id;
+    u16 flags;
+    u16 channel;
+
+    constexpr auto operator<=>(const Sample&) const = default;
+};
+
+struct Padded {
+    LIBBASE_SERIALISE(Padded, tag, value);
+    u8 tag;
+    u32 value;
+
+    constexpr auto operator<=>(const Padded&) const = default;
+};
+
+class Reordered {
+    LIBBASE_SERIALISE(Reordered, second, first);
+    u32 first;
+    u32 second;
+
+public:
+    Reordered(u32 second, u32 first) : first{first}, second{second} {}
+    constexpr auto operator<=>(const Reordered&) const = default;
+};
+}
+
+TEST_CASE("Serialisation: Packed structs") {
+    static_assert(detail::PackedStruct<Sample>::Packable<ser::Encoding::Fixed>());
+    static_assert(not detail::PackedStruct<Sample>::Packable<ser::Encoding::Varint>());
+    static_assert(not detail::PackedStruct<Padded>::Packable<ser::Encoding::Fixed>());
+    static_assert(not detail::PackedStruct<Align>::Packable<ser::Encoding::Fixed>());
+    static_assert(detail::PackedStruct<Size>::Packable<ser::Encoding::Fixed>());
+    static_assert(ser::FixedSerialisedSize<Sample> == sizeof(Sample));
+    static_assert(ser::FixedSerialisedSize<Size> == 8);
+
+    auto AsTuple = [](const Sample& s) { return std::tuple{s.timestamp, s.value, s.id, s.flags, s.channel}; };
+    std::vector<Sample> samples;
+    std::vector<decltype(AsTuple(Sample{}))> tuples;
+    for (u32 i = 0; i < 1'000; i++) {
+        samples.push_back(Sample{u64(i) * 0x0102'0304'0506, i * .5, i, u16(i * 3), u16(i >> 2)});
+        tuples.push_back(AsTuple(samples.back()));
+    }
+
+    // Packed structs are serialised the same way as their fields.
+    CHECK(SerialiseBE(samples[42]) == SerialiseBE(tuples[42]));
+    CHECK(SerialiseLE(samples[42]) == SerialiseLE(tuples[42]));
+    CHECK(SerialiseBE(samples) == SerialiseBE(tuples));
+    CHECK(SerialiseLE(samples) == SerialiseLE(tuples));
+    CHECK(DeserialiseBE<Sample>(SerialiseBE(samples[42])) == samples[42]);
+    CHECK(DeserialiseLE<Sample>(SerialiseLE(samples[42])) == samples[42]);
+    CHECK(DeserialiseBE<std::vector<Sample>>(SerialiseBE(samples)) == samples);
+    CHECK(DeserialiseLE<std::vector<Sample>>(SerialiseLE(samples)) == samples);
+    CHECK(ser::Deserialise<std::vector<Sample>, std::endian::big, ser::Encoding::Varint>(
+        ser::Serialise<std::endian::big, ser::Encoding::Varint>(samples)
+    ).value() == samples);
+
+    std::vector<Size> sizes{Size::Bytes(1), Size::Bits(3), Size::Bytes(1'000'000)};
+    CHECK(DeserialiseBE<std::vector<Size>>(SerialiseBE(sizes)) == sizes);
+    CHECK(DeserialiseLE<std::vector<Size>>(SerialiseLE(sizes)) == sizes);
+
+    SECTION("Structs that are not packed") {
+        Test(Padded{1, 2}, Bytes(1, 0, 0, 0, 2), Bytes(1, 2, 0, 0, 0));
+        Test(Reordered{1, 2}, Bytes(0, 0, 0, 1, 0, 0, 0, 2), Bytes(1, 0, 0, 0, 2, 0, 0, 0));
+
+        // Reordered is packable but has no default constructor, so we
+        // can’t resize() a vector of it.
+        static_assert(not ser::Serialiser<std::vector<Reordered>>::Bulk<ser::Encoding::Fixed>);
+
+        std::vector<Reordered> reordered{{1, 2}, {3, 4}};
+        CHECK(SerialiseLE(reordered) == SerialiseLE(std::vector<std::tuple<u32, u32>>{{1, 2}, {3, 4}}));
+        CHECK(DeserialiseLE<std::vector<Reordered>>(SerialiseLE(reordered)) == reordered);
+    }
+
+    SECTION("Not enough data") {
+        auto bytes = SerialiseLE(samples[0]);
+        bytes.pop_back();
+        CHECK(ser::Deserialise<Sample, std::endian::little>(bytes).error() == "Not enough data to read 24 bytes (23 bytes left)");
+    }
+}
+
 namespace {
 struct Foo {
     int x;
@@ -0,0 +1,83 @@
+#include "TestCommon.hh"
+
+#include <base/FS.hh>
+#include <base/StringBuilder.hh>
+#include <base/StringUtils.hh>
+
+using namespace base;
+
+TEST_CASE("StringBuilder: Appending") {
+    StringBuilder sb;
+    CHECK(sb.empty());
+    CHECK(sb.flatten() == "");
+
+    sb += "foo";
+    sb += 'b';
+    sb.append("ar").append(3, '!');
+    CHECK(sb.size() == 9);
+    CHECK(sb.flatten() == "foobar!!!");
+
+    std::string expected = sb.flatten();
+    std::string big(10'000, 'x');
+    for (int i = 0; i < 100; i++) {
+        sb += big;
+        sb += char('a' + i % 26);
+        expected += big;
+        expected += char('a' + i % 26);
+    }
+
+    CHECK(sb.size() == expected.size());
+    CHECK(sb.flatten() == expected);
+    CHECK(rgs::distance(sb.chunks()) > 1);
+
+    std::string joined;
+    for (auto c : sb.chunks()) joined += c;
+    CHECK(joined == expected);
+
+    sb.clear();
+    CHECK(sb.empty());
+    sb += "baz";
+    CHECK(sb.flatten() == "baz");
+}
+
+TEST_CASE("StringBuilder: reserve_hint()") {
+    StringBuilder sb{100};
+    sb += "abc";
+    sb.reserve_hint(1'000'000);
+    sb += std::string(1'000'000, 'y');
+    CHECK(rgs::distance(sb.chunks()) == 2);
+    CHECK(sb.size() == 1'000'003);
+
+    StringBuilder32 sb32;
+    sb32 += U"ššš";
+    sb32 += U'x';
+    CHECK(sb32.flatten() == U"šššx");
+}
+
+TEST_CASE("StringBuilder: str and utils overloads") {
+    str s = "foo bar foo";
+    CHECK(s.replace<StringBuilder>("foo", "quux").flatten() == "quux bar quux");
+    CHECK(s.replace<StringBuilder>('o', '0').flatten() == "f00 bar f00");
+    CHECK(s.replace_many<StringBuilder>("fb", "FB").flatten() == "Foo Bar Foo");
+    CHECK(s.remove_all<StringBuilder>("o ").flatten() == "fbarf");
+
+    StringBuilder sb;
+    utils::EscapeInto(sb, "a\nb\x01", true);
+    sb += '|';
+    utils::IndentInto(sb, "x\n\ny", 2);
+    CHECK(sb.flatten() == "a\\nb\\x01|  x\n\n  y");
+}
+
+TEST_CASE("StringBuilder: write_to()") {
+    StringBuilder sb;
+    for (int i = 0; i < 1'000; i++) sb += std::format("line {}\n", i);
+
+    auto path = fs::TempPath();
+    {
+        auto f = fs::File::Open(path, fs::OpenMode::Write).value();
+        sb.write_to(f).value();
+    }
+
+    CHECK(fs::File::ReadToContainer(path).value() == sb.flatten());
+    fs::File::Delete(path).value();
+}
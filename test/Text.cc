@@ -17,7 +17,6 @@ struct Catch::StringMaker<c32> {
     }
 };
 
-#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
 template <>
 struct Catch::StringMaker<std::u32string> {
     static std::string convert(std::u32string_view value) {
@@ -31,7 +30,6 @@ struct Catch::StringMaker<std::u32string_view> {
         return std::format("{}", value);
     }
 };
-#endif
 
 constexpr c32 Invalid = c32(c32::max().value + 1);
 constexpr c32 Chars[] {
@@ -48,7 +46,6 @@ constexpr c32 Chars[] {
     Invalid,
 };
 
-#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
 TEST_CASE("c32::category") {
     CHECK(Chars[0].category() == CharCategory::ControlChar);
     CHECK(Chars[1].category() == CharCategory::ControlChar);
@@ -87,20 +84,6 @@ TEST_CASE("c32::is_xid_start") {
     CHECK(not c32(U'&').is_xid_start());
 }
 
-TEST_CASE("c32::name") {
-    CHECK(Chars[0].name().error() == "Codepoint U+0000 has no name");
-    CHECK(Chars[1].name().error() == "Codepoint U+000A has no name");
-    CHECK(Chars[2].name().value() == "SPACE");
-    CHECK(Chars[3].name().value() == "LATIN SMALL LETTER Q");
-    CHECK(Chars[4].name().value() == "DIGIT THREE");
-    CHECK(Chars[5].name().value() == "NUMBER SIGN");
-    CHECK(Chars[6].name().value() == "LATIN CAPITAL LETTER U WITH DIAERESIS AND ACUTE");
-    CHECK(Chars[7].name().value() == "LATIN SMALL LETTER YOGH");
-    CHECK(Chars[8].name().value() == "LATIN CAPITAL LETTER THORN");
-    CHECK(Chars[9].name().value() == "LATIN CAPITAL LETTER X");
-    CHECK(Chars[10].name().error() == "Codepoint U+110000 has no name");
-}
-
 TEST_CASE("c32::swap_case") {
     CHECK(Chars[0].swap_case().value == 0);
     CHECK(Chars[1].swap_case().value == U'\n');
@@ -150,6 +133,42 @@ TEST_CASE("c32::width") {
     CHECK(c32(U'🌈').width() == 2);
 }
 
+TEST_CASE("c32: Case mapping edge cases") {
+    CHECK(c32(U'ß').to_upper() == U'ß');
+    CHECK(c32(U'ẞ').to_lower() == U'ß');
+    CHECK(c32(U'İ').to_lower() == U'i');
+    CHECK(c32(U'ᾀ').to_upper() == U'ᾈ');
+    CHECK(c32(U'ǅ').to_lower() == U'ǆ');
+    CHECK(c32(U'ǅ').to_upper() == U'Ǆ');
+    CHECK(c32(U'Ω').to_lower() == U'ω');
+    CHECK(c32(U'𐐀').to_lower() == U'𐐨');
+    CHECK(c32(0xD800).category() == CharCategory::Surrogate);
+    CHECK(c32(0xE000).category() == CharCategory::PrivateUseChar);
+    CHECK(c32(U'ᾼ').category() == CharCategory::TitlecaseLetter);
+    CHECK(c32(U'\u0301').is_xid_continue());
+    CHECK(not c32(U'\u0301').is_xid_start());
+    CHECK(c32(U'\u0301').width() == 1);
+
+    // Wide combining marks are wide, even though they take up no columns.
+    CHECK(c32(U'\u302A').width() == 2);
+    CHECK(c32(U'\u3099').width() == 2);
+}
+
+#ifdef LIBBASE_ENABLE_UNICODE_SUPPORT
+TEST_CASE("c32::name") {
+    CHECK(Chars[0].name().error() == "Codepoint U+0000 has no name");
+    CHECK(Chars[1].name().error() == "Codepoint U+000A has no name");
+    CHECK(Chars[2].name().value() == "SPACE");
+    CHECK(Chars[3].name().value() == "LATIN SMALL LETTER Q");
+    CHECK(Chars[4].name().value() == "DIGIT THREE");
+    CHECK(Chars[5].name().value() == "NUMBER SIGN");
+    CHECK(Chars[6].name().value() == "LATIN CAPITAL LETTER U WITH DIAERESIS AND ACUTE");
+    CHECK(Chars[7].name().value() == "LATIN SMALL LETTER YOGH");
+    CHECK(Chars[8].name().value() == "LATIN CAPITAL LETTER THORN");
+    CHECK(Chars[9].name().value() == "LATIN CAPITAL LETTER X");
+    CHECK(Chars[10].name().error() == "Codepoint U+110000 has no name");
+}
+
 TEST_CASE("FindCharsByName") {
     auto res = FindCharsByName([](c32 c, std::string_view name) {
         return std::ranges::contains(Chars, c) or (name.starts_with("LATIN") and c < 128);
@@ -182,6 +201,32 @@ TEST_CASE("Normalise") {
     CHECK(Normalise(U"\u212B", NormalisationForm::NFKD) == U"A\u030A"sv);
 }
 
+TEST_CASE("Normalise: ASCII and quick check") {
+    std::string ascii = "The quick brown fox jumps over the lazy dog; 0123456789!";
+    CHECK(IsNormalised(ascii, NormalisationForm::NFC));
+    CHECK(IsNormalised(ascii, NormalisationForm::NFKD));
+    CHECK(Normalise(ascii, NormalisationForm::NFD) == ascii);
+
+    // The last ASCII character combines with what comes after it.
+    CHECK(not IsNormalised("abce\u0301", NormalisationForm::NFC));
+    CHECK(IsNormalised("abce\u0301", NormalisationForm::NFD));
+    CHECK(Normalise("abce\u0301", NormalisationForm::NFC) == "abc\u00e9"sv);
+    CHECK(Normalise(U"abce\u0301", NormalisationForm::NFC) == U"abc\u00e9"sv);
+    CHECK(Normalise("abc\u00e9", NormalisationForm::NFD) == "abce\u0301"sv);
+    CHECK(not IsNormalised(U"\u212B", NormalisationForm::NFKC));
+    CHECK(IsNormalised(U"\u00C5", NormalisationForm::NFKC));
+    CHECK(IsNormalised("\u212B", NormalisationForm::None));
+
+    std::string out = "x";
+    NormaliseInto(out, "abce\u0301", NormalisationForm::NFC);
+    NormaliseInto(out, "def", NormalisationForm::NFC);
+    CHECK(out == "xabc\u00e9def");
+
+    std::u32string out32 = U"x";
+    NormaliseInto(out32, U"\u212B", NormalisationForm::NFKD);
+    CHECK(out32 == U"xA\u030A");
+}
+
 TEST_CASE("ToLower") {
     CHECK(ToLower( "AdðÐtÞewéÉȜ") ==  "adððtþewééȝ"sv);
     CHECK(ToLower(U"AdðÐtÞewéÉȜ") == U"adððtþewééȝ"sv);
@@ -192,6 +237,64 @@ TEST_CASE("ToUpper") {
     CHECK(ToUpper(U"adððtþewééȝ") == U"ADÐÐTÞEWÉÉȜ"sv);
 }
 
+TEST_CASE("ToLower/ToUpper: ASCII") {
+    // Long enough to go through the vectorised path.
+    std::string s;
+    for (int i = 0; i < 4; i++) s += "@AZaz[`{ The Quick Brown Fox 09!";
+    std::string lower, upper;
+    for (char c : s) {
+        lower += char(std::tolower(c));
+        upper += char(std::toupper(c));
+    }
+
+    CHECK(ToLower(s) == lower);
+    CHECK(ToUpper(s) == upper);
+    CHECK(ToLower(ToUTF32(s)) == ToUTF32(lower));
+    CHECK(ToUpper(ToUTF32(s)) == ToUTF32(upper));
+
+    std::string out = "X";
+    ToLowerInto(out, "ABC");
+    ToUpperInto(out, "def");
+    ToLowerInto(out, "ÄÖÜ");
+    CHECK(out == "XabcDEFäöü");
+
+    std::u32string out32 = U"X";
+    ToUpperInto(out32, U"abc");
+    ToLowerInto(out32, U"ΑΣ");
+    CHECK(out32 == U"XABCας");
+}
+
+TEST_CASE("Transliterator") {
+    Transliterator t("NFC; [:Punctuation:] Remove; Lower;");
+    CHECK(t(".,.:AERÁ") == "aerá");
+    CHECK(t(u".,.:AERÁ") == u"aerá");
+    CHECK(t(U".,.:AERÁ") == U"aerá");
+}
+
+TEST_CASE("TransliteratorPool") {
+    TransliteratorPool pool("NFC; [:Punctuation:] Remove; Lower;");
+    CHECK(pool(".,.:AERÁ") == "aerá");
+    CHECK(pool(u".,.:AERÁ") == u"aerá");
+    CHECK(pool(U".,.:AERÁ") == U"aerá");
+    CHECK(not TransliteratorPool::Create("Not-A-Transliterator").has_value());
+
+    std::vector<std::string> input;
+    for (int i = 0; i < 1'000; i++) input.push_back(std::format("!{}:ÄB", i));
+    std::vector<std::string_view> views{input.begin(), input.end()};
+
+    auto single = pool.batch(views, 1);
+    auto parallel = pool.batch(views, 4);
+    REQUIRE(parallel.size() == input.size());
+    CHECK(parallel == single);
+    CHECK(parallel[42] == "42äb");
+    CHECK(pool.batch(std::span<const std::string_view>{}).empty());
+
+    std::vector<std::u32string_view> views32{U"A.B", U"Ç"};
+    CHECK(pool.batch(views32, 2) == std::vector<std::u32string>{U"ab", U"ç"});
+}
+
+#endif
+
 TEST_CASE("8<->16<->32 Conversion") {
     std::string_view s1 = "áéẹḍțöźȕ";
     std::u16string_view s2 = u"áéẹḍțöźȕ";
@@ -216,13 +319,47 @@ TEST_CASE("8<->16<->32 Conversion") {
     CHECK(ToUTF16(c) == u"🌈"sv);
 }
 
-TEST_CASE("Transliterator") {
-    Transliterator t("NFC; [:Punctuation:] Remove; Lower;");
-    CHECK(t(".,.:AERÁ") == "aerá");
-    CHECK(t(u".,.:AERÁ") == u"aerá");
-    CHECK(t(U".,.:AERÁ") == U"aerá");
+TEST_CASE("8<->16<->32 Conversion: Long strings") {
+    // Long enough to go through the vectorised ASCII paths.
+    std::string s1 = std::string(100, 'x') + "ä" + std::string(37, 'y') + "🌈" + "z";
+    std::u16string s2 = std::u16string(100, u'x') + u"ä" + std::u16string(37, u'y') + u"🌈" + u"z";
+    std::u32string s3 = std::u32string(100, U'x') + U"ä" + std::u32string(37, U'y') + U"🌈" + U"z";
+
+    CHECK(ToUTF8(s2) == s1);
+    CHECK(ToUTF8(s3) == s1);
+    CHECK(ToUTF16(s1) == s2);
+    CHECK(ToUTF16(s3) == s2);
+    CHECK(ToUTF32(s1) == s3);
+    CHECK(ToUTF32(s2) == s3);
 }
-#endif
+
+TEST_CASE("8<->16<->32 Conversion: Invalid input") {
+    CHECK(ToUTF32("a\xff" "b"sv) == U"a\uFFFDb"sv);
+    CHECK(ToUTF32("a\xe6\x97"sv) == U"a\uFFFD"sv);
+    CHECK(ToUTF32("\xc0\x80"sv) == U"\uFFFD\uFFFD"sv);
+    CHECK(ToUTF32("\xed\xa0\x80"sv) == U"\uFFFD\uFFFD\uFFFD"sv);
+    CHECK(ToUTF8(u"a\xD800" u"b"sv) == "a\uFFFDb"sv);
+    CHECK(ToUTF8(u"\xDC00"sv) == "\uFFFD"sv);
+    CHECK(ToUTF16(U"\x110000"sv) == u"\uFFFD"sv);
+    CHECK(ToUTF8(U"\xD800"sv) == "\uFFFD"sv);
+}
+
+TEST_CASE("ValidateUTF8()") {
+    CHECK(ValidateUTF8("").has_value());
+    CHECK(ValidateUTF8("abc").has_value());
+    CHECK(ValidateUTF8("áéẹḍțöźȕ🌈").has_value());
+    CHECK(ValidateUTF8(std::string(100, 'x') + "ä").has_value());
+
+    auto invalid = std::string(100, 'x') + "ä\xff";
+    auto res = ValidateUTF8(invalid);
+    REQUIRE(not res.has_value());
+    CHECK(res.error() == "Invalid UTF-8 at offset 102");
+
+    CHECK(not ValidateUTF8("\xe6\x97").has_value());
+    CHECK(not ValidateUTF8("\xc0\x80").has_value());
+    CHECK(not ValidateUTF8("\xf4\x90\x80\x80").has_value());
+}
+
 
 TEST_CASE("CCType functions") {
     for (u8 c = 0;; c++) {
@@ -242,18 +379,42 @@ TEST_CASE("CCType functions") {
     }
 }
 
-#if defined(LIBBASE_ENABLE_UNICODE_SUPPORT) || defined(LIBBASE_ENABLE_LLVM_BINDINGS_UNICODE)
 TEST_CASE("Text: ColumnWidth(UTF-8)") {
     CHECK(text::ColumnWidth("") == 0);
     CHECK(text::ColumnWidth("1234") == 4);
     CHECK(text::ColumnWidth("\033[33m1234\033[m") == 4);
     CHECK(text::ColumnWidth("x\033[33m1234\033[my") == 6);
+    CHECK(text::ColumnWidth("a\tb\x01") == 6);
+    CHECK(text::ColumnWidth("桜🌈x") == 5);
+    CHECK(text::ColumnWidth("e\u0301") == 1);
+    CHECK(text::ColumnWidth("\u200B\u00AD") == 1);
+    CHECK(text::ColumnWidth("a\xffb\xe6\x97") == 4);
+    CHECK(text::ColumnWidth("\033[1m桜\033[m ok") == 5);
+
+    // Long enough to exercise the vectorised code paths.
+    std::string long_text;
+    for (int i = 0; i < 100; i++) long_text += "abcdef 桜\t";
+    CHECK(text::ColumnWidth(long_text) == 100 * 13);
 }
-#endif
 
 TEST_CASE("Text: ColumnWidth(UTF-32)") {
     CHECK(text::ColumnWidth(U"") == 0);
     CHECK(text::ColumnWidth(U"1234") == 4);
     CHECK(text::ColumnWidth(U"\033[33m1234\033[m") == 4);
     CHECK(text::ColumnWidth(U"x\033[33m1234\033[my") == 6);
+    CHECK(text::ColumnWidth(U"a\tb\x01") == 6);
+    CHECK(text::ColumnWidth(U"桜🌈x") == 5);
+    CHECK(text::ColumnWidth(U"e\u0301") == 1);
+}
+
+TEST_CASE("Text: ColumnWidth benchmark", "[.benchmark]") {
+    std::string ascii;
+    std::string mixed;
+    for (int i = 0; i < 10'000; i++) {
+        ascii += "\033[32mINFO\033[m Some log message that is mostly ASCII\n";
+        mixed += "\033[32mINFO\033[m Ein Beispiel für gemischten Text, 桜の木\n";
+    }
+
+    BENCHMARK("ASCII") { return text::ColumnWidth(ascii); };
+    BENCHMARK("Mixed") { return text::ColumnWidth(mixed); };
 }
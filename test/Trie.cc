@@ -1,4 +1,5 @@
 #include "TestCommon.hh"
+#include <base/Serialisation.hh>
 #include <base/Trie.hh>
 
 using namespace base;
@@ -199,3 +200,117 @@ TEST_CASE("Trie::is_prefix_of()") {
     CHECK(not trie.is_prefix_of("qq"));
     CHECK(not trie.is_prefix_of("xafcaefgagef"));
 }
+
+TEST_CASE("Trie: Serialisation") {
+    trie a{
+        {"foo", "bar"},
+        {"football", "baz"},
+        {"tba", "quux"},
+        {"x", ""},
+    };
+
+    a.add("oof", "rab");
+    auto data = ser::Serialise<std::endian::native>(a);
+
+    SECTION("Frozen") {
+        auto f = ser::Deserialise<frozen_trie, std::endian::native>(data).value();
+        CHECK(f.replace("footbafoo") == "barquuxbar");
+        CHECK(f.replace("footballfoo") == "bazbar");
+        CHECK(f.replace("xfoooofx") == "barrab");
+        CHECK(f.get("foo") == "bar");
+        CHECK(f.get("fo") == std::nullopt);
+        CHECK(f.is_prefix_of("tbaq"));
+        CHECK(not f.is_prefix_of("tb"));
+    }
+
+    SECTION("Round trip") {
+        auto b = ser::Deserialise<trie, std::endian::native>(data).value();
+        CHECK(b.replace("footbafoo") == "barquuxbar");
+        CHECK(b.replace("xfoooofx") == "barrab");
+        CHECK(ser::Serialise<std::endian::native>(b) == data);
+    }
+
+    SECTION("Big endian") {
+        auto be = ser::Serialise<std::endian::big>(u32trie{{U"ab", U"cd"}, {U"b", U"e"}});
+        auto b = ser::Deserialise<u32trie, std::endian::big>(be).value();
+        CHECK(b.replace(U"abbab") == U"cdecd");
+    }
+
+    SECTION("Truncated") {
+        data.pop_back();
+        CHECK(not ser::Deserialise<frozen_trie, std::endian::native>(data));
+    }
+
+    SECTION("Source") {
+        usz pos = 0;
+        ser::Reader<std::endian::native> r{[&](MutableByteSpan into) -> Result<usz> {
+            auto n = std::min(into.size(), data.size() - pos);
+            std::copy_n(data.begin() + isz(pos), n, into.begin());
+            pos += n;
+            return n;
+        }};
+
+        CHECK(r.read<frozen_trie>().error() == "Frozen tries cannot be loaded from a source");
+    }
+
+    SECTION("Corrupted") {
+        // Nodes start after the 3 header fields and consist of 6 fields.
+        auto Corrupt = [&](u32 node, u32 field, u32 value, std::string_view error) {
+            auto copy = data;
+            std::memcpy(copy.data() + (3 + node * 6 + field) * sizeof(u32), &value, sizeof(u32));
+            auto frozen = ser::Deserialise<frozen_trie, std::endian::native>(copy);
+            auto mutable_trie = ser::Deserialise<trie, std::endian::native>(copy);
+            REQUIRE(not frozen.has_value());
+            REQUIRE(not mutable_trie.has_value());
+            CHECK_THAT(frozen.error(), ContainsSubstring(std::string{error}));
+            CHECK_THAT(mutable_trie.error(), ContainsSubstring(std::string{error}));
+        };
+
+        Corrupt(1, 1, 1'000, "Fail link 1000 of node 1 is out of bounds");
+        Corrupt(1, 1, 1, "Fail link of node 1 does not lead to a shallower node");
+        Corrupt(0, 1, 1, "Fail link of node 0 does not lead to a shallower node");
+        Corrupt(0, 3, u32(-1), "Edges of node 0 are out of bounds");
+        Corrupt(1, 5, 1'000, "Replacement of node 1 is out of bounds");
+        Corrupt(1, 0, 5, "has the wrong depth");
+    }
+
+    SECTION("Bogus counts") {
+        for (usz field = 0; field < 3; field++) {
+            auto copy = data;
+            u32 count = u32(-1);
+            std::memcpy(copy.data() + field * sizeof(u32), &count, sizeof(u32));
+            auto res = ser::Deserialise<trie, std::endian::native>(copy);
+            REQUIRE(not res.has_value());
+            CHECK_THAT(res.error(), ContainsSubstring("Not enough data to read"));
+            CHECK(not ser::Deserialise<frozen_trie, std::endian::native>(copy));
+        }
+    }
+}
+
+TEST_CASE("Trie: Static") {
+    static constexpr static_trie<12> a{
+        {"foo", "bar"},
+        {"football", "baz"},
+        {"tba", "quux"},
+    };
+
+    static_assert(a.get("foo") == "bar");
+    static_assert(a.replace("footbafoo") == "barquuxbar");
+    CHECK(a.replace("footbal") == "barquuxl");
+    CHECK(a.replace("football") == "baz");
+    CHECK(a.is_prefix_of("tbaq"));
+
+    static constexpr auto b = MakeStaticTrie<[] {
+        return std::to_array<std::pair<std::string_view, std::string_view>>({
+            {"abcdef", "1"},
+            {"bcdef", "3"},
+            {"cdef", "4"},
+            {"def", "5"},
+            {"ef", "6"},
+            {"g", "7"},
+        });
+    }>();
+
+    CHECK(b.replace("abcdeg") == "abcde7");
+    CHECK(b.replace("xbcdefx") == "x3x");
+}
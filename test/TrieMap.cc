@@ -1,4 +1,5 @@
 #include "TestCommon.hh"
+#include <base/Serialisation.hh>
 #include <base/TrieMap.hh>
 
 using namespace base;
@@ -99,3 +100,126 @@ TEST_CASE("TrieMap: Keep track of last match") {
     s = "123456789";
     CHECK(s.match_prefix(t) == 3); CHECK(s.size() == 1);
 }
+
+TEST_CASE("TrieMap: Splitting edges") {
+    TrieMap<int> t;
+    t.add("abcdef", 1);
+    t.add("abcxyz", 2);
+    t.add("ab", 3);
+    t.add("abcdefgh", 4);
+    t.add("b", 5);
+
+    CHECK(str("abcdefg").match_prefix(t) == 1);
+    CHECK(str("abcxy").match_prefix(t) == 3);
+    CHECK(str("abcxyz!").match_prefix(t) == 2);
+    CHECK(str("abc").match_prefix(t) == 3);
+    CHECK(str("abcdefgh").match_prefix(t) == 4);
+    CHECK(str("a").match_prefix(t) == std::nullopt);
+    CHECK(str("bcd").match_prefix(t) == 5);
+
+    t.add("abc", 6);
+    CHECK(str("abcxy").match_prefix(t) == 6);
+    t.add("ab", 7);
+    CHECK(str("abq").match_prefix(t) == 7);
+}
+
+TEST_CASE("TrieMap: match_prefix_ptr()") {
+    const TrieMap<std::string> t{
+        {"foo", "x"},
+        {"foobar", "y"},
+    };
+
+    str s = "foobarbaz";
+    auto v = s.match_prefix_ptr(t);
+    REQUIRE(v);
+    CHECK(*v == "y");
+    CHECK(s == "baz");
+    CHECK(s.match_prefix_ptr(t) == nullptr);
+    CHECK(s == "baz");
+
+    auto [depth, ptr] = t.match_prefix_ptr("foob");
+    CHECK(depth == 3);
+    CHECK(ptr == t.match_prefix_ptr("foo").second);
+}
+
+TEST_CASE("TrieMap: Serialisation") {
+    const TrieMap<std::string> t{
+        {"123", "a"},
+        {"12345", "b"},
+        {"x", "c"},
+    };
+
+    auto data = ser::Serialise<std::endian::big>(t);
+    auto u = ser::Deserialise<TrieMap<std::string>, std::endian::big>(data).value();
+    CHECK(str("1234").match_prefix(u) == "a");
+    CHECK(str("123456").match_prefix(u) == "b");
+    CHECK(str("xy").match_prefix(u) == "c");
+    CHECK(str("y").match_prefix(u) == std::nullopt);
+    CHECK(ser::Serialise<std::endian::big>(u) == data);
+
+    SECTION("Corrupted") {
+        // Labels, node count, and then a root with a single child 'a' -> 1.
+        auto Load = [](u32 label_size, u32 child) {
+            auto bytes = ser::Serialise<std::endian::big>(std::tuple{
+                std::string{"ab"},
+                u32(2),
+                u32(0), u32(0), std::optional<int>{}, u32(1), u32('a'), u32(1),
+                u32(0), label_size, std::optional<int>{}, u32(1), u32('a'), child,
+            });
+
+            return ser::Deserialise<TrieMap<int>, std::endian::big>(bytes).error();
+        };
+
+        CHECK(Load(1, 1) == "Trie node 1 has more than one parent");
+        CHECK(Load(1, 0) == "Trie node 0 has more than one parent");
+        CHECK(Load(0, 1) == "Label of trie node 1 is empty");
+    }
+
+    SECTION("Bogus counts") {
+        // A root whose child count is all that is left of the input.
+        auto Load = [](u32 node_count, u32 children) {
+            auto bytes = ser::Serialise<std::endian::big>(std::tuple{
+                std::string{"ab"},
+                node_count,
+                u32(0), u32(0), std::optional<int>{}, children,
+            });
+
+            return ser::Deserialise<TrieMap<int>, std::endian::big>(bytes).error();
+        };
+
+        CHECK_THAT(Load(u32(-1), 0), ContainsSubstring("Not enough data to read 4294967295 trie nodes"));
+        CHECK(Load(1, 1) == "Trie node 0 has too many children");
+    }
+}
+
+TEST_CASE("TrieMap: Static") {
+    static constexpr StaticTrieMap<int, 9> t{
+        {"123", 1},
+        {"12345", 2},
+        {"12345678", 3},
+    };
+
+    static_assert(t.match_prefix("1234")->first == 3);
+    static_assert(t.match_prefix("1234")->second == 1);
+    static_assert(not t.match_prefix("12").has_value());
+
+    str s = "123456X";
+    CHECK(s.match_prefix(t) == 2);
+    CHECK(s.size() == 2);
+
+    static constexpr auto k = MakeStaticTrieMap<[] {
+        return std::to_array<std::pair<std::string_view, int>>({
+            {"if", 1},
+            {"in", 2},
+            {"else", 3},
+            {"elseif", 4},
+        });
+    }>();
+
+    s = "elseifs";
+    CHECK(s.match_prefix(k) == 4);
+    CHECK(s == "s");
+    CHECK(str("elsewhere").match_prefix(k) == 3);
+    CHECK(str("i").match_prefix(k) == std::nullopt);
+    CHECK(str("").match_prefix(k) == std::nullopt);
+}
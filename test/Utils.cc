@@ -36,6 +36,26 @@ TEST_CASE("Escape()") {
     CHECK(utils::Escape("%1(xyz%)", false, true) == "%%1(xyz%%)");
 }
 
+TEST_CASE("Escape(): Long inputs") {
+    // Make sure we hit both the vectorised scan and the tail.
+    std::string in, expected;
+    for (int i = 0; i < 1'000; i++) {
+        auto c = char(i * 37 % 256);
+        in += c;
+        if (c == '\\') expected += "\\\\";
+        else if (c == '"') expected += "\\\"";
+        else if (c == '%') expected += "%%";
+        else if (text::IsPrint(c)) expected += c;
+        else expected += utils::Escape(std::string_view{&c, 1});
+    }
+
+    CHECK(utils::Escape(in, true, true) == expected);
+
+    std::string out = "prefix:";
+    utils::EscapeInto(out, in, true, true);
+    CHECK(out == "prefix:" + expected);
+}
+
 TEST_CASE("escaped()") {
     using Vec = std::vector<std::string_view>;
     CHECK_THAT(utils::escaped(Vec{}, false), RangeEquals(Vec{}));
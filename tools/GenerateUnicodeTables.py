@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# Generate the Unicode property tables in src/text/UnicodeTables.inc.
+#
+# The tables use the version of the Unicode Character Database that ships
+# with the Python interpreter used to run this script; rerun it with a newer
+# Python to update them:
+#
+#   python3 tools/GenerateUnicodeTables.py > src/text/UnicodeTables.inc
+#
+# Every property is stored as a two-stage table: the first stage maps the
+# upper bits of a code point to a block of the second stage, which contains
+# the values for the 256 code points in that block, packed into as few bits
+# as possible. Identical blocks are only stored once.
+#
+# The tables are declared in include/base/Text.hh, which also contains the
+# code that looks up values in them, so the two need to be kept in sync.
+
+import sys
+import unicodedata
+
+MAX_CODEPOINT = 0x10FFFF
+BLOCK_SIZE = 256
+
+
+def width(cp: int) -> int:
+    c = chr(cp)
+    cat = unicodedata.category(c)
+
+    # Soft hyphens are displayed.
+    if cp == 0xAD: return 1
+
+    # Control characters, combining marks, and format characters have no width.
+    if cat in ('Cc', 'Mn', 'Me', 'Cf'): return 0
+
+    # Hangul medial vowels and final consonants combine with the preceding
+    # character.
+    if 0x1160 <= cp <= 0x11FF: return 0
+
+    # As per Unicode Standard Annex #11, ambiguous characters are not wide.
+    if unicodedata.east_asian_width(c) in ('W', 'F'): return 2
+    return 1
+
+
+def wide(cp: int) -> int:
+    # Unlike 'width()', this is purely the East_Asian_Width property, so
+    # wide combining marks are still wide.
+    return int(unicodedata.east_asian_width(chr(cp)) in ('W', 'F'))
+
+
+# Same order as 'base::text::CharCategory'.
+CATEGORIES = [
+    'Cn', 'Lu', 'Ll', 'Lt', 'Lm', 'Lo', 'Mn', 'Me', 'Mc', 'Nd', 'Nl', 'No', 'Zs', 'Zl', 'Zp',
+    'Cc', 'Cf', 'Co', 'Cs', 'Pd', 'Ps', 'Pe', 'Pc', 'Po', 'Sm', 'Sc', 'Sk', 'So', 'Pi', 'Pf',
+]
+
+
+def category(cp: int) -> int:
+    return CATEGORIES.index(unicodedata.category(chr(cp)))
+
+
+def xid(cp: int) -> int:
+    # Python identifiers are made up of XID_Start and XID_Continue
+    # characters, except that they may also start with an underscore.
+    c = chr(cp)
+    start = cp != ord('_') and c.isidentifier()
+    cont = ('a' + c).isidentifier()
+    return int(start) | int(cont) << 1
+
+
+def simple_lower(cp: int) -> int:
+    # Only U+0130 has a lowercase mapping that is longer than one code
+    # point; its simple mapping is the first code point of that.
+    return ord(chr(cp).lower()[0])
+
+
+def simple_upper(cp: int, titlecase: dict[int, int]) -> int:
+    # Python only exposes full case mappings. If the full uppercase mapping
+    # of a character is longer than one code point, its simple mapping is
+    # the titlecase letter that maps back to it, if there is one (e.g. for
+    # Greek letters with ypogegrammeni), and the character itself otherwise
+    # (e.g. for U+00DF).
+    upper = chr(cp).upper()
+    if len(upper) == 1: return ord(upper)
+    return titlecase.get(cp, cp)
+
+
+def deltas(mapping: list[int]) -> tuple[list[int], list[int]]:
+    """Convert a mapping to indices into a list of offsets."""
+    offsets = [0]
+    indices = []
+    for cp, m in enumerate(mapping):
+        d = m - cp
+        if d not in offsets: offsets.append(d)
+        indices.append(offsets.index(d))
+    return indices, offsets
+
+
+def emit_table(name: str, values: list[int], bits: int):
+    per_byte = 8 // bits
+    bytes_per_block = BLOCK_SIZE // per_byte
+    blocks: dict[bytes, int] = {}
+    stage1: list[int] = []
+    stage2 = bytearray()
+
+    for start in range(0, MAX_CODEPOINT + 1, BLOCK_SIZE):
+        block = bytearray(bytes_per_block)
+        for i in range(BLOCK_SIZE):
+            v = values[start + i]
+            assert v < (1 << bits)
+            block[i // per_byte] |= v << ((i % per_byte) * bits)
+
+        key = bytes(block)
+        if key not in blocks:
+            blocks[key] = len(blocks)
+            stage2 += key
+        stage1.append(blocks[key])
+
+    assert len(blocks) <= 256
+    print(f'/// {name}: {bits} bits per code point, {len(blocks)} unique blocks.')
+    print(f'const u8 {name}Stage1[{len(stage1)}]{{')
+    emit_bytes(stage1)
+    print('};')
+    print()
+    print(f'const u8 {name}Stage2[{len(stage2)}]{{')
+    emit_bytes(stage2)
+    print('};')
+    print()
+
+
+def emit_deltas(name: str, offsets: list[int]):
+    print(f'/// {name}: offsets to add to a code point to map it.')
+    print(f'const i32 {name}[{len(offsets)}]{{')
+    for i in range(0, len(offsets), 12):
+        print('    ' + ' '.join(f'{d},' for d in offsets[i:i + 12]))
+    print('};')
+    print()
+
+
+def emit_bytes(data):
+    for i in range(0, len(data), 24):
+        print('    ' + ' '.join(f'{b},' for b in data[i:i + 24]))
+
+
+def main():
+    print('// Generated by tools/GenerateUnicodeTables.py; do not edit.')
+    print(f'// Unicode version: {unicodedata.unidata_version}')
+    print()
+    codepoints = range(MAX_CODEPOINT + 1)
+    titlecase = {
+        ord(chr(cp).lower()): cp
+        for cp in codepoints
+        if unicodedata.category(chr(cp)) == 'Lt' and len(chr(cp).lower()) == 1
+    }
+
+    lower, lower_deltas = deltas([simple_lower(cp) for cp in codepoints])
+    upper, upper_deltas = deltas([simple_upper(cp, titlecase) for cp in codepoints])
+    emit_table('Category', [category(cp) for cp in codepoints], 8)
+    emit_table('XID', [xid(cp) for cp in codepoints], 2)
+    emit_table('Lower', lower, 8)
+    emit_deltas('LowerDeltas', lower_deltas)
+    emit_table('Upper', upper, 8)
+    emit_deltas('UpperDeltas', upper_deltas)
+    emit_table('Width', [width(cp) for cp in codepoints], 2)
+    emit_table('Wide', [wide(cp) for cp in codepoints], 1)
+
+
+if __name__ == '__main__':
+    sys.exit(main())